@@ -1,17 +1,19 @@
 #include "ai.h"
-#include <QRandomGenerator>
 #include <QtMath>
 #include <QDebug>
 
-AI::AI(Player *controlledPlayer) : player(controlledPlayer), currentState(AIState::FIND_WEAPON),
-    stateTimer(0), shootCooldown(0)
+AI::AI(Player *controlledPlayer, quint32 seed) : player(controlledPlayer), currentState(AIState::FIND_WEAPON),
+    stateTimer(0), shootCooldown(0), actions(0), rng(seed)
 {
     targetPosition = player->pos();
 }
 
-void AI::update(Player *targetPlayer, QList<Item*> &items, QList<Platform*> &platforms,
-                QList<Projectile*> &projectiles, QGraphicsScene *scene)
+quint8 AI::update(Player *targetPlayer, const EntityRegistry &registry)
 {
+    const EntityTable &items = registry.table(EntityKind::ITEM);
+    const EntityTable &platforms = registry.table(EntityKind::PLATFORM);
+    actions = 0;
+
     // 减少计时器
     stateTimer--;
     shootCooldown--;
@@ -19,11 +21,11 @@ void AI::update(Player *targetPlayer, QList<Item*> &items, QList<Platform*> &pla
     // 当前状态处理
     switch (currentState) {
     case AIState::FIND_WEAPON:
-        if (!player->hasWeapon() || player->getWeaponName() == "拳头") {
-            findWeapon(items, platforms);
+        if (!player->hasWeapon() || player->getWeapon().getType() == WeaponType::FIST) {
+            findWeapon(items);
         } else {
             // 已有武器，转向寻找护甲或玩家
-            if (!player->getArmor() && QRandomGenerator::global()->bounded(100) < 40) {
+            if (!player->hasArmor() && rng.bounded(100) < 40) {
                 currentState = AIState::FIND_ARMOR;
                 stateTimer = 100;
             } else {
@@ -34,8 +36,8 @@ void AI::update(Player *targetPlayer, QList<Item*> &items, QList<Platform*> &pla
         break;
 
     case AIState::FIND_ARMOR:
-        if (!player->getArmor()) {
-            findArmor(items, platforms);
+        if (!player->hasArmor()) {
+            findArmor(items);
         } else {
             // 已有护甲，转向寻找玩家
             currentState = AIState::SEEK_PLAYER;
@@ -45,8 +47,8 @@ void AI::update(Player *targetPlayer, QList<Item*> &items, QList<Platform*> &pla
 
     case AIState::SEEK_PLAYER:
         // 如果生命值低且没有武器，可能会寻找武器或逃跑
-        if (player->getHealth() < 30 && (!player->hasWeapon() || player->getWeaponName() == "拳头")) {
-            if (QRandomGenerator::global()->bounded(100) < 70) {
+        if (player->getHealth() < 30 && (!player->hasWeapon() || player->getWeapon().getType() == WeaponType::FIST)) {
+            if (rng.bounded(100) < 70) {
                 currentState = AIState::FIND_WEAPON;
                 stateTimer = 150;
             } else {
@@ -55,8 +57,8 @@ void AI::update(Player *targetPlayer, QList<Item*> &items, QList<Platform*> &pla
             }
         }
         // 如果生命值低，可能会寻找护甲
-        else if (player->getHealth() < 50 && !player->getArmor()) {
-            if (QRandomGenerator::global()->bounded(100) < 50) {
+        else if (player->getHealth() < 50 && !player->hasArmor()) {
+            if (rng.bounded(100) < 50) {
                 currentState = AIState::FIND_ARMOR;
                 stateTimer = 120;
             }
@@ -74,11 +76,11 @@ void AI::update(Player *targetPlayer, QList<Item*> &items, QList<Platform*> &pla
         break;
 
     case AIState::ATTACK:
-        attack(targetPlayer, projectiles, scene);
+        attack(targetPlayer);
 
         // 随机决定是否继续攻击或转入其他状态
         if (stateTimer <= 0) {
-            int decision = QRandomGenerator::global()->bounded(100);
+            int decision = rng.bounded(100);
             if (decision < 30) {
                 currentState = AIState::RETREAT;
                 stateTimer = 60;
@@ -97,7 +99,7 @@ void AI::update(Player *targetPlayer, QList<Item*> &items, QList<Platform*> &pla
 
         // 撤退一段时间后，转向其他行为
         if (stateTimer <= 0) {
-            int decision = QRandomGenerator::global()->bounded(100);
+            int decision = rng.bounded(100);
             if (decision < 40) {
                 currentState = AIState::FIND_WEAPON;
                 stateTimer = 100;
@@ -111,7 +113,7 @@ void AI::update(Player *targetPlayer, QList<Item*> &items, QList<Platform*> &pla
     case AIState::IDLE:
         // 闲置状态结束后转向其他行为
         if (stateTimer <= 0) {
-            int decision = QRandomGenerator::global()->bounded(100);
+            int decision = rng.bounded(100);
             if (decision < 30) {
                 currentState = AIState::FIND_WEAPON;
                 stateTimer = 80;
@@ -128,14 +130,16 @@ void AI::update(Player *targetPlayer, QList<Item*> &items, QList<Platform*> &pla
 
     // 移动到目标位置
     moveToTarget();
+
+    return actions;
 }
 
-void AI::findWeapon(QList<Item*> &items, QList<Platform*> &platforms)
+void AI::findWeapon(const EntityTable &items)
 {
-    Item* bestItem = findBestItem(items);
+    int bestItem = findBestItem(items);
 
-    if (bestItem) {
-        targetPosition = bestItem->pos();
+    if (bestItem >= 0) {
+        targetPosition = items.position(bestItem);
     } else if (stateTimer <= 0) {
         // 找不到武器或时间到，转向寻找玩家
         currentState = AIState::SEEK_PLAYER;
@@ -143,19 +147,20 @@ void AI::findWeapon(QList<Item*> &items, QList<Platform*> &platforms)
     }
 }
 
-void AI::findArmor(QList<Item*> &items, QList<Platform*> &platforms)
+void AI::findArmor(const EntityTable &items)
 {
     // 寻找护甲类物品
-    Item* armorItem = nullptr;
-    for (Item* item : items) {
-        if (item->getType() == ItemType::LIGHT_ARMOR || item->getType() == ItemType::BULLETPROOF_VEST) {
-            armorItem = item;
+    int armorItem = -1;
+    for (int i = 0; i < items.size(); i++) {
+        ItemType type = ItemType(items.subtype[i]);
+        if (type == ItemType::LIGHT_ARMOR || type == ItemType::BULLETPROOF_VEST) {
+            armorItem = i;
             break;
         }
     }
 
-    if (armorItem) {
-        targetPosition = armorItem->pos();
+    if (armorItem >= 0) {
+        targetPosition = items.position(armorItem);
     } else if (stateTimer <= 0) {
         // 找不到护甲或时间到，转向寻找玩家
         currentState = AIState::SEEK_PLAYER;
@@ -163,7 +168,7 @@ void AI::findArmor(QList<Item*> &items, QList<Platform*> &platforms)
     }
 }
 
-void AI::seekPlayer(Player *targetPlayer, QList<Platform*> &platforms)
+void AI::seekPlayer(Player *targetPlayer, const EntityTable &platforms)
 {
     QPointF playerPos = targetPlayer->pos();
     targetPosition = playerPos;
@@ -172,31 +177,31 @@ void AI::seekPlayer(Player *targetPlayer, QList<Platform*> &platforms)
     targetPosition = findPath(player->pos(), playerPos, platforms);
 }
 
-void AI::attack(Player *targetPlayer, QList<Projectile*> &projectiles, QGraphicsScene *scene)
+void AI::attack(Player *targetPlayer)
 {
     QPointF playerPos = targetPlayer->pos();
 
     // 调整面向
     if (playerPos.x() < player->x()) {
-        player->setFacingRight(false);
+        actions |= INPUT_FACE_LEFT;
     } else {
-        player->setFacingRight(true);
+        actions |= INPUT_FACE_RIGHT;
     }
 
     // 射击
     if (shootCooldown <= 0) {
-        player->fire(projectiles, scene);
+        actions |= INPUT_FIRE;
         shootCooldown = 30; // 设置射击冷却时间
     }
 
     // 随机移动以避免被击中
     if (stateTimer % 30 == 0) {
-        int moveDirection = QRandomGenerator::global()->bounded(3) - 1; // -1, 0, 1
+        int moveDirection = rng.bounded(3) - 1; // -1, 0, 1
         targetPosition = player->pos() + QPointF(moveDirection * 50, 0);
     }
 }
 
-void AI::retreat(Player *targetPlayer, QList<Platform*> &platforms)
+void AI::retreat(Player *targetPlayer, const EntityTable &platforms)
 {
     QPointF playerPos = targetPlayer->pos();
     QPointF retreatDir;
@@ -213,7 +218,7 @@ void AI::retreat(Player *targetPlayer, QList<Platform*> &platforms)
     targetPosition = findPath(player->pos(), retreatPos, platforms);
 }
 
-QPointF AI::findPath(QPointF start, QPointF end, QList<Platform*> &platforms)
+QPointF AI::findPath(QPointF start, QPointF end, const EntityTable &platforms)
 {
     // 简化版路径规划
     // 首先检查目标是否直接可达
@@ -222,26 +227,26 @@ QPointF AI::findPath(QPointF start, QPointF end, QList<Platform*> &platforms)
     }
 
     // 如果不能直接到达，尝试找到最近的平台
-    Platform* nearestPlatform = findNearestPlatform(end, platforms);
-    if (nearestPlatform) {
+    int nearestPlatform = findNearestPlatform(end, platforms);
+    if (nearestPlatform >= 0) {
         // 返回平台上方的位置
-        return QPointF(end.x(), nearestPlatform->y() - 30);
+        return QPointF(end.x(), platforms.y[nearestPlatform] - 30);
     }
 
     // 无法找到路径，返回原始目标
     return end;
 }
 
-bool AI::canReachPosition(QPointF position, QList<Platform*> &platforms)
+bool AI::canReachPosition(QPointF position, const EntityTable &platforms)
 {
     // 检查位置下方是否有平台支撑
     return isOnPlatform(position, platforms);
 }
 
-bool AI::isOnPlatform(QPointF position, QList<Platform*> &platforms)
+bool AI::isOnPlatform(QPointF position, const EntityTable &platforms)
 {
-    for (Platform* platform : platforms) {
-        QRectF platformRect = platform->sceneBoundingRect();
+    for (int i = 0; i < platforms.size(); i++) {
+        QRectF platformRect = platforms.bounds(i);
         if (position.x() >= platformRect.left() &&
             position.x() <= platformRect.right() &&
             qAbs(position.y() + 30 - platformRect.top()) < 20) {
@@ -251,73 +256,44 @@ bool AI::isOnPlatform(QPointF position, QList<Platform*> &platforms)
     return false;
 }
 
-Platform* AI::findNearestPlatform(QPointF position, QList<Platform*> &platforms)
+int AI::findNearestPlatform(QPointF position, const EntityTable &platforms)
 {
-    Platform* nearest = nullptr;
+    int nearest = -1;
     qreal minDist = 1000000;
 
-    for (Platform* platform : platforms) {
-        QPointF platformCenter = platform->sceneBoundingRect().center();
+    for (int i = 0; i < platforms.size(); i++) {
+        QPointF platformCenter = platforms.bounds(i).center();
         qreal dist = QLineF(position, platformCenter).length();
 
         if (dist < minDist) {
             minDist = dist;
-            nearest = platform;
+            nearest = i;
         }
     }
 
     return nearest;
 }
 
-Item* AI::findBestItem(QList<Item*> &items)
+int AI::findBestItem(const EntityTable &items)
 {
     // 寻找最优物品
-    Item* bestItem = nullptr;
+    int bestItem = -1;
     int bestScore = -1;
 
-    for (Item* item : items) {
-        int score = 0;
-
-        // 基于物品类型评分
-        switch (item->getType()) {
-        case ItemType::RIFLE:
-            score = 80;
-            break;
-        case ItemType::SNIPER:
-            score = 90;
-            break;
-        case ItemType::KNIFE:
-            score = 30;
-            break;
-        case ItemType::BALL:
-            score = 60;
-            break;
-        case ItemType::LIGHT_ARMOR:
-            score = 50;
-            break;
-        case ItemType::BULLETPROOF_VEST:
-            score = 70;
-            break;
-        case ItemType::BANDAGE:
-            if (player->getHealth() < 50) score = 40;
-            else score = 20;
-            break;
-        case ItemType::MEDKIT:
-            if (player->getHealth() < 30) score = 85;
-            else score = 40;
-            break;
-        case ItemType::ADRENALINE:
-            score = 65;
-            break;
-        }
+    for (int i = 0; i < items.size(); i++) {
+        // 基于物品类型评分，生命值低时医疗用品更有价值
+        const ItemStats &stats = itemStats(ItemType(items.subtype[i]));
+        int score = stats.aiScore;
+        if (player->getHealth() < stats.aiUrgentHealth)
+            score = stats.aiUrgentScore;
 
         // 考虑距离因素
-        qreal dist = QLineF(player->pos(), item->pos()).length();
+        qreal dist = QLineF(player->pos(), items.position(i)).length();
         score = score - dist / 10;
 
         if (score > bestScore) {
             bestScore = score;
-            bestItem = item;
+            bestItem = i;
         }
     }
 
@@ -330,20 +306,7 @@ bool AI::canAttackFrom(QPointF position, QPointF targetPosition)
     qreal dist = QLineF(position, targetPosition).length();
 
     // 基于武器类型确定攻击范围
-    int attackRange = 100; // 默认范围
-
-    QString weaponName = player->getWeaponName();
-    if (weaponName == "拳头") {
-        attackRange = 50;
-    } else if (weaponName == "小刀") {
-        attackRange = 70;
-    } else if (weaponName == "步枪") {
-        attackRange = 300;
-    } else if (weaponName == "狙击枪") {
-        attackRange = 500;
-    } else if (weaponName == "实心球") {
-        attackRange = 200;
-    }
+    int attackRange = player->getWeapon().getStats().attackRange;
 
     return dist <= attackRange;
 }
@@ -355,22 +318,20 @@ void AI::moveToTarget()
 
     // 计算移动方向
     if (targetPosition.x() < currentPos.x() - 5) {
-        player->moveLeft();
+        actions |= INPUT_LEFT;
     } else if (targetPosition.x() > currentPos.x() + 5) {
-        player->moveRight();
+        actions |= INPUT_RIGHT;
     } else {
-        player->stopMoving();
+        actions |= INPUT_STOP;
     }
 
     // 跳跃逻辑
     if (targetPosition.y() < currentPos.y() - 50 && player->isOnGround()) {
-        player->jump();
+        actions |= INPUT_JUMP;
     }
 
     // 下蹲逻辑 - 在目标位置下方或需要拾取物品时下蹲
     if (targetPosition.y() > currentPos.y() + 30) {
-        player->crouch(true);
-    } else {
-        player->crouch(false);
+        actions |= INPUT_CROUCH;
     }
 }
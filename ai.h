@@ -1,53 +1,61 @@
-#ifndef AI_H
-#define AI_H
-
-#include <QObject>
-#include <QPointF>
-#include "player.h"
-#include "platform.h"
-#include "item.h"
-
-enum class AIState {
-    FIND_WEAPON,
-    FIND_ARMOR,
-    SEEK_PLAYER,
-    ATTACK,
-    RETREAT,
-    IDLE
-};
-
-class AI : public QObject
-{
-    Q_OBJECT
-
-public:
-    AI(Player *controlledPlayer);
-
-    void update(Player *targetPlayer, QList<Item*> &items, QList<Platform*> &platforms,
-                QList<Projectile*> &projectiles, QGraphicsScene *scene);
-
-private:
-    Player *player;
-    AIState currentState;
-    QPointF targetPosition;
-    int stateTimer;
-    int shootCooldown;
-
-    // AI行为方法
-    void findWeapon(QList<Item*> &items, QList<Platform*> &platforms);
-    void findArmor(QList<Item*> &items, QList<Platform*> &platforms);
-    void seekPlayer(Player *targetPlayer, QList<Platform*> &platforms);
-    void attack(Player *targetPlayer, QList<Projectile*> &projectiles, QGraphicsScene *scene);
-    void retreat(Player *targetPlayer, QList<Platform*> &platforms);
-
-    // 辅助方法
-    QPointF findPath(QPointF start, QPointF end, QList<Platform*> &platforms);
-    bool canReachPosition(QPointF position, QList<Platform*> &platforms);
-    bool isOnPlatform(QPointF position, QList<Platform*> &platforms);
-    Platform* findNearestPlatform(QPointF position, QList<Platform*> &platforms);
-    Item* findBestItem(QList<Item*> &items);
-    bool canAttackFrom(QPointF position, QPointF targetPosition);
-    void moveToTarget();
-};
-
-#endif // AI_H
+#ifndef AI_H
+#define AI_H
+
+#include <QObject>
+#include <QPointF>
+#include <QRandomGenerator>
+#include "player.h"
+#include "entityregistry.h"
+#include "platform.h"
+#include "item.h"
+#include "playerinput.h"
+
+enum class AIState {
+    FIND_WEAPON,
+    FIND_ARMOR,
+    SEEK_PLAYER,
+    ATTACK,
+    RETREAT,
+    IDLE
+};
+
+class AI : public QObject
+{
+    Q_OBJECT
+
+public:
+    // seed决定AI的随机决策，同一种子和输入下行为完全相同
+    AI(Player *controlledPlayer, quint32 seed);
+
+    // 决定本帧的动作，以输入位的形式返回，由游戏世界统一执行
+    // 这样AI的决策可以和人类按键一样被录像和回放
+    // 物品和平台直接从注册表的物品表、平台表中读取
+    quint8 update(Player *targetPlayer, const EntityRegistry &registry);
+
+private:
+    Player *player;
+    AIState currentState;
+    QPointF targetPosition;
+    int stateTimer;
+    int shootCooldown;
+    quint8 actions;         // 本帧决定的动作
+    QRandomGenerator rng;   // 每个AI独立的随机数流，不使用全局生成器
+
+    // AI行为方法
+    void findWeapon(const EntityTable &items);
+    void findArmor(const EntityTable &items);
+    void seekPlayer(Player *targetPlayer, const EntityTable &platforms);
+    void attack(Player *targetPlayer);
+    void retreat(Player *targetPlayer, const EntityTable &platforms);
+
+    // 辅助方法，返回行号的在找不到时返回-1
+    QPointF findPath(QPointF start, QPointF end, const EntityTable &platforms);
+    bool canReachPosition(QPointF position, const EntityTable &platforms);
+    bool isOnPlatform(QPointF position, const EntityTable &platforms);
+    int findNearestPlatform(QPointF position, const EntityTable &platforms);
+    int findBestItem(const EntityTable &items);
+    bool canAttackFrom(QPointF position, QPointF targetPosition);
+    void moveToTarget();
+};
+
+#endif // AI_H
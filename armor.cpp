@@ -1,64 +1,41 @@
 #include "armor.h"
 
-Armor::Armor(ArmorType type) : type(type)
+Armor::Armor(ArmorType type)
+    : type(type), durability(armorStats(type).durability)
 {
-    // 设置初始耐久度
-    switch (type) {
-    case ArmorType::LIGHT:
-        durability = 100; // 轻甲不消耗耐久度
-        break;
-    case ArmorType::BULLETPROOF:
-        durability = 100;
-        break;
-    default:
-        durability = 0;
-        break;
-    }
 }
 
 int Armor::absorbDamage(int damage, ProjectileType projectileType)
 {
-    int remainingDamage = damage;
+    const ArmorStats &stats = armorStats(type);
+    int index = int(projectileType);
 
-    if (type == ArmorType::LIGHT) {
-        // 轻甲防御
-        if (projectileType == ProjectileType::MELEE) {
-            // 完全免疫拳头伤害
-            if (damage <= 5) {
-                remainingDamage = 0;
-            } else {
-                // 小刀伤害减半
-                remainingDamage = damage / 2;
-            }
-        }
-    }
-    else if (type == ArmorType::BULLETPROOF) {
-        // 防弹衣
-        if (projectileType == ProjectileType::BULLET) {
-            // 防弹衣吸收70%的子弹伤害
-            int absorbedDamage = damage * 0.7;
-            remainingDamage = damage - absorbedDamage;
+    // 不超过免疫上限的伤害完全吸收，否则按比例吸收（向下取整）
+    int absorbedDamage;
+    if (damage <= stats.immuneUpTo[index])
+        absorbedDamage = damage;
+    else
+        absorbedDamage = damage * stats.absorb[index];
 
-            // 降低耐久度
-            durability -= absorbedDamage;
-            if (durability <= 0) {
-                durability = 0;
-                // 确保isExpired()返回true
-            }
+    // 会磨损的护甲降低耐久度
+    if (stats.wears) {
+        durability -= absorbedDamage;
+        if (durability <= 0) {
+            durability = 0;
+            // 确保isExpired()返回true
         }
     }
 
-    return remainingDamage;
+    return damage - absorbedDamage;
 }
 
 QString Armor::getName() const
 {
-    switch (type) {
-    case ArmorType::LIGHT:
-        return "轻甲";
-    case ArmorType::BULLETPROOF:
-        return QString("防弹衣(%1)").arg(durability);
-    default:
-        return "无";
-    }
+    const ArmorStats &stats = armorStats(type);
+    QString name = QString::fromUtf8(stats.name);
+
+    // 会磨损的护甲显示剩余耐久度
+    if (stats.wears)
+        return QString("%1(%2)").arg(name).arg(durability);
+    return name;
 }
@@ -1,25 +1,19 @@
 #ifndef ARMOR_H
 #define ARMOR_H
 
-#include <QObject>
-#include "projectile.h"
+#include <QString>
+#include "gamedata.h"
 
-enum class ArmorType {
-    NONE,
-    LIGHT,  // 轻甲
-    BULLETPROOF  // 防弹衣
-};
-
-class Armor : public QObject
+// 护甲是普通的值类型，直接存放在玩家表的护甲列中，NONE表示没有护甲
+// 装备和损坏时原地赋值，不分配内存
+class Armor
 {
-    Q_OBJECT
-
 public:
-    Armor(ArmorType type);
+    explicit Armor(ArmorType type = ArmorType::NONE);
 
     ArmorType getType() const { return type; }
     int getDurability() const { return durability; }
-    bool isExpired() const { return type == ArmorType::BULLETPROOF && durability <= 0; }
+    bool isExpired() const { return armorStats(type).wears && durability <= 0; }
 
     // 处理伤害
     int absorbDamage(int damage, ProjectileType projectileType);
@@ -0,0 +1,147 @@
+#include "assetmanager.h"
+#include <QCoreApplication>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <functional>
+
+namespace
+{
+// 在工作线程上加载一张图片，完成后交给回调写入缓存
+class AssetLoadTask : public QRunnable
+{
+public:
+    AssetLoadTask(std::function<void()> work) : work(std::move(work)) {}
+    void run() override { work(); }
+
+private:
+    std::function<void()> work;
+};
+}
+
+AssetManager &AssetManager::instance()
+{
+    static AssetManager manager;
+    return manager;
+}
+
+AssetManager::AssetManager()
+{
+    // 静态对象析构时QApplication已经销毁，不能再释放QPixmap；在退出事件循环时就清空缓存
+    if (QCoreApplication *app = QCoreApplication::instance())
+        QObject::connect(app, &QCoreApplication::aboutToQuit, app, [this]() { clear(); });
+}
+
+AssetManager::~AssetManager()
+{
+    pool.waitForDone();
+}
+
+QString AssetManager::keyOf(const QString &path, const QSize &size, Qt::AspectRatioMode mode)
+{
+    return QString("%1@%2x%3/%4").arg(path).arg(size.width()).arg(size.height()).arg(int(mode));
+}
+
+QImage AssetManager::decode(const QString &path)
+{
+    QImage image(path);
+    if (image.isNull())
+        return image;
+    return image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+}
+
+QImage AssetManager::scale(const QImage &source, const QSize &size, Qt::AspectRatioMode mode)
+{
+    if (source.isNull() || !size.isValid())
+        return source;
+    return source.scaled(size.width(), size.height(), mode, Qt::SmoothTransformation)
+        .convertToFormat(QImage::Format_ARGB32_Premultiplied);
+}
+
+void AssetManager::preload(const QString &path, const QSize &size, Qt::AspectRatioMode mode)
+{
+    preload(path, QVector<QSize>{size}, mode);
+}
+
+void AssetManager::preload(const QString &path, const QVector<QSize> &sizes, Qt::AspectRatioMode mode)
+{
+    // 只提交还没有加载、也没有正在加载的尺寸
+    QVector<QSize> missing;
+    {
+        QMutexLocker locker(&mutex);
+        for (const QSize &size : sizes)
+        {
+            QString key = keyOf(path, size, mode);
+            if (images.contains(key) || pending.contains(key))
+                continue;
+            pending.insert(key, true);
+            missing.append(size);
+        }
+    }
+    if (missing.isEmpty())
+        return;
+
+    pool.start(new AssetLoadTask([this, path, missing, mode]() {
+        // 所有尺寸都从同一张原图缩放，任务结束时原图随之释放
+        QImage source = decode(path);
+        for (const QSize &size : missing)
+        {
+            QString key = keyOf(path, size, mode);
+            QImage image = scale(source, size, mode);
+            QMutexLocker locker(&mutex);
+            images.insert(key, image);
+            pending.remove(key);
+        }
+    }));
+}
+
+void AssetManager::waitForPreload()
+{
+    pool.waitForDone();
+}
+
+QPixmap AssetManager::pixmap(const QString &path, const QSize &size, Qt::AspectRatioMode mode)
+{
+    QString key = keyOf(path, size, mode);
+    auto cached = pixmaps.constFind(key);
+    if (cached != pixmaps.constEnd())
+        return *cached;
+
+    bool loading;
+    bool loaded;
+    {
+        QMutexLocker locker(&mutex);
+        loading = pending.contains(key);
+        loaded = images.contains(key);
+    }
+
+    if (loading)
+    {
+        pool.waitForDone();
+    }
+    else if (!loaded)
+    {
+        // 没有预加载过，只能在这里同步加载
+        QImage image = scale(decode(path), size, mode);
+        QMutexLocker locker(&mutex);
+        images.insert(key, image);
+    }
+
+    QImage image;
+    {
+        QMutexLocker locker(&mutex);
+        image = images.value(key);
+    }
+
+    QPixmap result = image.isNull() ? QPixmap() : QPixmap::fromImage(image);
+    pixmaps.insert(key, result);
+    return result;
+}
+
+void AssetManager::clear()
+{
+    pool.waitForDone();
+    QMutexLocker locker(&mutex);
+    images.clear();
+    pending.clear();
+    pixmaps.clear();
+}
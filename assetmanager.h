@@ -0,0 +1,59 @@
+#ifndef ASSETMANAGER_H
+#define ASSETMANAGER_H
+
+#include <QHash>
+#include <QImage>
+#include <QMutex>
+#include <QPixmap>
+#include <QSize>
+#include <QString>
+#include <QThreadPool>
+#include <QVector>
+
+// 图片资源管理：每张图片（按路径、目标尺寸和缩放方式区分）只解码和缩放一次
+// 启动时用preload()在工作线程上解码、缩放并转换为预乘alpha格式，之后每局开始只是查表，
+// 不再读磁盘或解码；返回的QPixmap是隐式共享的，多处使用同一张图不会复制像素
+class AssetManager
+{
+public:
+    static AssetManager &instance();
+
+    // 在工作线程上加载，立即返回；size为空表示保持原尺寸
+    void preload(const QString &path, const QSize &size = QSize(),
+                 Qt::AspectRatioMode mode = Qt::IgnoreAspectRatio);
+
+    // 同一张图片的多种尺寸：在一个工作线程上只解码一次，依次缩放出所有尺寸
+    void preload(const QString &path, const QVector<QSize> &sizes,
+                 Qt::AspectRatioMode mode = Qt::IgnoreAspectRatio);
+
+    // 等待所有预加载完成
+    void waitForPreload();
+
+    // 取图片，只能在界面线程调用（QPixmap不能在其他线程创建）
+    // 正在预加载的会等待其完成，没有预加载过的在当前线程同步加载并缓存
+    // 文件不存在或无法解码时返回空图，之后也不会再尝试
+    QPixmap pixmap(const QString &path, const QSize &size = QSize(),
+                   Qt::AspectRatioMode mode = Qt::IgnoreAspectRatio);
+
+    // 删除所有缓存（测试或换皮肤时使用）
+    void clear();
+
+private:
+    AssetManager();
+    ~AssetManager();
+
+    static QString keyOf(const QString &path, const QSize &size, Qt::AspectRatioMode mode);
+    // 解码和缩放，结果都是预乘alpha格式，绘制时不需要再转换
+    // 全尺寸的原图只在缩放期间存在，不放进缓存
+    static QImage decode(const QString &path);
+    static QImage scale(const QImage &source, const QSize &size, Qt::AspectRatioMode mode);
+
+    QThreadPool pool;
+
+    QMutex mutex;                       // 保护images和pending，工作线程会写入
+    QHash<QString, QImage> images;      // 解码好的图片
+    QHash<QString, bool> pending;       // 已提交但还没完成的预加载
+    QHash<QString, QPixmap> pixmaps;    // 只在界面线程访问
+};
+
+#endif // ASSETMANAGER_H
@@ -0,0 +1,431 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRandomGenerator>
+#include <QStringList>
+#include <QTextStream>
+#include <QVector>
+#include <functional>
+#include "simworld.h"
+#include "ai.h"
+
+// 一个内核在一种规模下的测量结果
+struct BenchResult
+{
+    QString kernel;
+    int entities = 0;
+    int platforms = 0;
+    qint64 iterations = 0;
+    double meanNs = 0;
+    double minNs = 0;
+};
+
+// 微基准测试的场景：一个按规模放大的游戏世界，可以直接调用SimWorld的私有内核
+// 世界的面积默认随实体和平台数量增长，新增的平台分布在默认关卡的高度范围内，
+// 物品和投射物在所有平台上方，离两名玩家都很远，因此测量期间不会有拾取、命中或结束对局
+class SimWorldBench
+{
+public:
+    SimWorldBench(int entities, int platformCount, quint32 seed)
+        : SimWorldBench(platformCount, seed, worldWidth(entities, platformCount),
+                        worldHeight(entities, platformCount))
+    {
+    }
+
+    // 固定世界大小，用于只能在默认1200x800范围内活动的实体
+    SimWorldBench(int platformCount, quint32 seed, int width, int height)
+        : world(width, height), rng(seed)
+    {
+        world.reset(GameMode::PLAYER_VS_PLAYER, seed);
+
+        // 默认关卡已有6个平台，其余随机放在下半部分
+        EntityTable &platforms = world.registry.table(EntityKind::PLATFORM);
+        while (platforms.size() < platformCount)
+        {
+            qreal width = rng.bounded(100, 300);
+            qreal x = rng.bounded(world.gameWidth - int(width));
+            qreal y = world.gameHeight - PLATFORM_BAND + rng.bounded(PLATFORM_BAND - 60);
+            PlatformType type = PlatformType(rng.bounded(3));
+            world.addPlatform(x, y, width, 30, type);
+        }
+        world.platformGrid.build(platforms, QRectF(0, 0, world.gameWidth, world.gameHeight));
+    }
+
+    // 在平台上方随机生成物品，全部处于下落状态
+    void addItems(int count)
+    {
+        EntityTable &items = world.registry.table(EntityKind::ITEM);
+        for (int i = 0; i < count; i++)
+        {
+            world.spawnItem();
+            int row = items.size() - 1;
+            items.x[row] = items.prevX[row] = 300 + rng.bounded(world.gameWidth - 400);
+            items.y[row] = items.prevY[row] = rng.bounded(world.gameHeight - PLATFORM_BAND - 60);
+        }
+        itemStartY = items.y;
+    }
+
+    // 让所有物品回到初始高度重新下落
+    void resetItems()
+    {
+        EntityTable &items = world.registry.table(EntityKind::ITEM);
+        for (int i = 0; i < items.size(); i++)
+        {
+            items.y[i] = itemStartY[i];
+            items.vy[i] = 0;
+            items.setFlag(i, ENTITY_ON_GROUND, false);
+        }
+    }
+
+    // 在平台上方水平发射子弹，双方各一半，寿命足够长，测量期间不会到期
+    void addProjectiles(int count)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            projectileStart.append(QPointF(300 + rng.bounded(world.gameWidth - 400),
+                                           rng.bounded(world.gameHeight - PLATFORM_BAND - 60)));
+        }
+        resetProjectiles();
+    }
+
+    // 子弹飞出世界或被回收后，从初始位置重新发射
+    void resetProjectiles()
+    {
+        world.projectiles.releaseAll();
+        for (int i = 0; i < projectileStart.size(); i++)
+        {
+            const QPointF &start = projectileStart[i];
+            world.projectiles.acquire(start.x(), start.y(), i % 2 == 0, ProjectileType::BULLET,
+                                      18, 15, 1 + i % 2, 1 << 30);
+        }
+    }
+
+    // SimWorld私有内核的转发，供下面的各个测量函数使用
+    EntityRegistry &registry() { return world.registry; }
+    ProjectilePool &projectiles() { return world.projectiles; }
+    qreal stepScale() const { return world.stepScale; }
+    Player *player(int id) { return id == 1 ? world.player1 : world.player2; }
+    void collidePlayerWithPlatforms(Player *player) { world.collidePlayerWithPlatforms(player); }
+    void checkCollisions() { world.checkCollisions(); }
+    void updateItems() { world.updateItems(); }
+
+    static int worldWidth(int entities, int platforms)
+    {
+        return qMax(1200, int(std::sqrt(double(entities + platforms)) * 60));
+    }
+
+    static int worldHeight(int entities, int platforms)
+    {
+        return worldWidth(entities, platforms) * 2 / 3;
+    }
+
+    // 默认关卡最高的平台在底部以上500像素，新增平台也放在这个范围内
+    static const int PLATFORM_BAND = 500;
+
+    SimWorld world;
+    QRandomGenerator rng;
+    QVector<double> itemStartY;
+    QVector<QPointF> projectileStart;
+};
+
+// 反复运行kernel直到累计时间超过minNs（至少5次），reset在每次运行前执行，不计入时间
+static BenchResult measure(const QString &kernel, int entities, int platforms, qint64 minNs,
+                           const std::function<void()> &reset, const std::function<void()> &run)
+{
+    // 预热：填充缓存、分配好重复使用的数组
+    for (int i = 0; i < 3; i++)
+    {
+        reset();
+        run();
+    }
+
+    BenchResult result;
+    result.kernel = kernel;
+    result.entities = entities;
+    result.platforms = platforms;
+
+    QElapsedTimer timer;
+    qint64 total = 0;
+    qint64 fastest = -1;
+    while (total < minNs || result.iterations < 5)
+    {
+        reset();
+        timer.start();
+        run();
+        qint64 elapsed = timer.nsecsElapsed();
+        total += elapsed;
+        fastest = fastest < 0 ? elapsed : qMin(fastest, elapsed);
+        result.iterations++;
+    }
+
+    result.meanNs = double(total) / result.iterations;
+    result.minNs = double(fastest);
+    return result;
+}
+
+static void noReset()
+{
+}
+
+// 各个内核，每个函数在一种规模下测量一次
+static BenchResult benchPlayerPhysics(int entities, int platforms, quint32 seed, qint64 minNs)
+{
+    // 玩家的移动范围固定为1200x800，世界不随规模放大，平台越多越密
+    SimWorldBench bench(platforms, seed, 1200, 800);
+    QVector<Player *> players;
+    QVector<QPointF> starts;
+    for (int i = 0; i < entities; i++)
+    {
+        Player *player = new Player(bench.registry(), bench.rng.bounded(1160), bench.rng.bounded(700),
+                                    Qt::blue, 3 + i);
+        players.append(player);
+        starts.append(player->pos());
+    }
+
+    // 每秒换一次方向，让玩家在走下平台、下落和着陆之间循环
+    // 每两秒让所有玩家回到初始位置，测量结果与运行次数无关
+    // 与SimWorld::step()一样，每帧开始时保存上一帧的位置，平台碰撞按这一帧的位移扫掠
+    const int CYCLE_TICKS = 120;
+    qint64 tick = 0;
+    BenchResult result = measure("player_physics", entities, platforms, minNs, [&]() {
+        if (tick % CYCLE_TICKS == 0)
+        {
+            for (int i = 0; i < players.size(); i++)
+            {
+                players[i]->setPos(starts[i]);
+                players[i]->setXVelocity(0);
+                players[i]->setYVelocity(0);
+                players[i]->setOnGround(false);
+            }
+        }
+        bench.registry().savePreviousPositions();
+    }, [&]() {
+        bool right = (tick++ % CYCLE_TICKS) < CYCLE_TICKS / 2;
+        for (Player *player : players)
+        {
+            if (right)
+                player->moveRight();
+            else
+                player->moveLeft();
+            player->applyGravity(bench.stepScale());
+            player->move(bench.stepScale());
+            bench.collidePlayerWithPlatforms(player);
+        }
+    });
+    qDeleteAll(players);
+    return result;
+}
+
+static BenchResult benchProjectileIntegrate(int entities, int platforms, quint32 seed, qint64 minNs)
+{
+    SimWorldBench bench(entities, platforms, seed);
+    bench.addProjectiles(entities);
+    return measure("projectile_integrate", entities, platforms, minNs, noReset, [&]() {
+        bench.projectiles().integrate(bench.stepScale());
+    });
+}
+
+static BenchResult benchCheckCollisions(int entities, int platforms, quint32 seed, qint64 minNs)
+{
+    // 物品和投射物各一半；玩家下蹲，拾取判定不会被短路
+    SimWorldBench bench(entities, platforms, seed);
+    bench.addItems(entities / 2);
+    bench.addProjectiles(entities - entities / 2);
+    bench.player(1)->crouch(true);
+    bench.player(2)->crouch(true);
+    return measure("check_collisions", entities, platforms, minNs, [&]() {
+        bench.resetProjectiles();
+        bench.registry().savePreviousPositions();
+        bench.projectiles().integrate(bench.stepScale());
+    }, [&]() {
+        bench.checkCollisions();
+    });
+}
+
+static BenchResult benchItemPhysics(int entities, int platforms, quint32 seed, qint64 minNs)
+{
+    // 最坏情况：所有物品都在下落，每个都要查询网格
+    SimWorldBench bench(entities, platforms, seed);
+    bench.addItems(entities);
+    return measure("item_physics", entities, platforms, minNs, [&]() {
+        bench.resetItems();
+    }, [&]() {
+        bench.updateItems();
+    });
+}
+
+static BenchResult benchWeaponFire(int entities, int platforms, quint32 seed, qint64 minNs)
+{
+    // 每次运行连续发射entities发，每发之间超过冷却时间，弹药用光时换一把新枪
+    SimWorldBench bench(0, platforms, seed);
+    qint64 nowMs = 0;
+    return measure("weapon_fire", entities, platforms, minNs, [&]() {
+        bench.projectiles().releaseAll();
+    }, [&]() {
+        Weapon weapon(WeaponType::RIFLE);
+        int cooldown = weapon.getStats().cooldownMs;
+        for (int i = 0; i < entities; i++)
+        {
+            if (weapon.isAmmoEmpty())
+                weapon = Weapon(WeaponType::RIFLE);
+            nowMs += cooldown + 1;
+            weapon.fire(bench.projectiles(), 600, 100, i % 2 == 0, 1, nowMs);
+        }
+    });
+}
+
+static BenchResult benchArmorAbsorb(int entities, int platforms, quint32 seed, qint64 minNs)
+{
+    // 伤害和投射物类型预先随机好，护甲损坏时换一件新的
+    QRandomGenerator rng(seed);
+    QVector<int> damage(entities);
+    QVector<ProjectileType> types(entities);
+    for (int i = 0; i < entities; i++)
+    {
+        damage[i] = rng.bounded(1, 31);
+        types[i] = ProjectileType(rng.bounded(PROJECTILE_TYPE_COUNT));
+    }
+
+    // 结果写入volatile变量，避免编译器把循环优化掉
+    volatile int sink = 0;
+    return measure("armor_absorb", entities, platforms, minNs, noReset, [&]() {
+        Armor armor(ArmorType::BULLETPROOF);
+        int absorbed = 0;
+        for (int i = 0; i < entities; i++)
+        {
+            if (armor.isExpired())
+                armor = Armor(ArmorType::BULLETPROOF);
+            absorbed += armor.absorbDamage(damage[i], types[i]);
+        }
+        sink = absorbed;
+    });
+}
+
+static BenchResult benchAIUpdate(int entities, int platforms, quint32 seed, qint64 minNs)
+{
+    // AI在entities个物品和platforms个平台中做一次决策
+    SimWorldBench bench(entities, platforms, seed);
+    bench.addItems(entities);
+    AI ai(bench.player(2), seed);
+    return measure("ai_update", entities, platforms, minNs, noReset, [&]() {
+        ai.update(bench.player(1), bench.registry());
+    });
+}
+
+typedef BenchResult (*BenchKernel)(int entities, int platforms, quint32 seed, qint64 minNs);
+
+struct BenchEntry
+{
+    const char *name;
+    BenchKernel kernel;
+};
+
+static const BenchEntry BENCH_KERNELS[] = {
+    {"player_physics", benchPlayerPhysics},
+    {"projectile_integrate", benchProjectileIntegrate},
+    {"check_collisions", benchCheckCollisions},
+    {"item_physics", benchItemPhysics},
+    {"weapon_fire", benchWeaponFire},
+    {"armor_absorb", benchArmorAbsorb},
+    {"ai_update", benchAIUpdate},
+};
+
+static QVector<int> parseSizes(const QString &text)
+{
+    QVector<int> sizes;
+    for (const QString &part : text.split(',', Qt::SkipEmptyParts))
+    {
+        int size = part.trimmed().toInt();
+        if (size > 0)
+            sizes.append(size);
+    }
+    return sizes;
+}
+
+// 微基准测试：在按实体数和平台数合成的场景上测量模拟的各个热点内核
+// 结果写成JSON，便于比较修改前后的差异
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+    QCoreApplication::setApplicationName("HW1_1_bench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("模拟内核微基准测试");
+    parser.addHelpOption();
+    QCommandLineOption entitiesOption("entities", "实体数量，逗号分隔", "list", "10,100,1000,10000,100000");
+    QCommandLineOption platformsOption("platforms", "平台数量，逗号分隔", "list", "100");
+    QCommandLineOption kernelsOption("kernels", "只运行这些内核，逗号分隔（默认全部）", "list");
+    QCommandLineOption minTimeOption("min-time", "每种规模至少测量的时间（毫秒）", "ms", "200");
+    QCommandLineOption seedOption("seed", "合成场景的随机种子", "seed", "1");
+    QCommandLineOption outputOption("output", "把JSON结果写到该文件（默认输出到标准输出）", "file");
+    parser.addOption(entitiesOption);
+    parser.addOption(platformsOption);
+    parser.addOption(kernelsOption);
+    parser.addOption(minTimeOption);
+    parser.addOption(seedOption);
+    parser.addOption(outputOption);
+    parser.process(a);
+
+    QVector<int> entityCounts = parseSizes(parser.value(entitiesOption));
+    QVector<int> platformCounts = parseSizes(parser.value(platformsOption));
+    QStringList kernels = parser.value(kernelsOption).split(',', Qt::SkipEmptyParts);
+    qint64 minNs = qint64(qMax(1, parser.value(minTimeOption).toInt())) * 1000000;
+    quint32 seed = parser.value(seedOption).toUInt();
+
+    // 进度输出到标准错误，标准输出只留给JSON
+    QTextStream err(stderr);
+    QJsonArray results;
+    for (const BenchEntry &entry : BENCH_KERNELS)
+    {
+        if (!kernels.isEmpty() && !kernels.contains(entry.name))
+            continue;
+        for (int platforms : platformCounts)
+        {
+            for (int entities : entityCounts)
+            {
+                BenchResult result = entry.kernel(entities, platforms, seed, minNs);
+                err << QString("%1 实体=%2 平台=%3: %4 ns/次, %5 ns/实体\n")
+                           .arg(result.kernel, -20).arg(entities).arg(platforms)
+                           .arg(result.meanNs, 0, 'f', 0).arg(result.meanNs / entities, 0, 'f', 2);
+                err.flush();
+
+                QJsonObject json;
+                json.insert("kernel", result.kernel);
+                json.insert("entities", result.entities);
+                json.insert("platforms", result.platforms);
+                json.insert("iterations", result.iterations);
+                json.insert("mean_ns", result.meanNs);
+                json.insert("min_ns", result.minNs);
+                json.insert("ns_per_entity", result.meanNs / result.entities);
+                results.append(json);
+            }
+        }
+    }
+
+    QJsonObject root;
+    root.insert("benchmark", "HW1_1_bench");
+    root.insert("seed", qint64(seed));
+    root.insert("min_time_ms", minNs / 1000000);
+    root.insert("results", results);
+    QByteArray json = QJsonDocument(root).toJson(QJsonDocument::Indented);
+
+    if (parser.isSet(outputOption))
+    {
+        QFile file(parser.value(outputOption));
+        if (!file.open(QIODevice::WriteOnly) || file.write(json) < 0)
+        {
+            err << QString("无法写入%1: %2\n").arg(file.fileName(), file.errorString());
+            return 1;
+        }
+    }
+    else
+    {
+        QTextStream out(stdout);
+        out << json;
+    }
+    return 0;
+}
@@ -0,0 +1,184 @@
+#include "entityregistry.h"
+#include <QGraphicsItem>
+#include <algorithm>
+#include "sweptaabb.h"
+
+EntityRegistry::EntityRegistry()
+{
+}
+
+EntityRegistry::~EntityRegistry()
+{
+    clear();
+}
+
+void EntityRegistry::resizeRows(EntityTable &table, int count)
+{
+    table.id.resize(count);
+    table.x.resize(count);
+    table.y.resize(count);
+    table.prevX.resize(count);
+    table.prevY.resize(count);
+    table.vx.resize(count);
+    table.vy.resize(count);
+    table.gravity.resize(count);
+    table.width.resize(count);
+    table.height.resize(count);
+    table.health.resize(count);
+    table.weapon.resize(count);
+    table.armor.resize(count);
+    table.age.resize(count);
+    table.lifespan.resize(count);
+    table.subtype.resize(count);
+    table.owner.resize(count);
+    table.flags.resize(count);
+    table.proxy.resize(count);
+}
+
+void EntityRegistry::moveRow(EntityTable &table, int from, int to)
+{
+    table.id[to] = table.id[from];
+    table.x[to] = table.x[from];
+    table.y[to] = table.y[from];
+    table.prevX[to] = table.prevX[from];
+    table.prevY[to] = table.prevY[from];
+    table.vx[to] = table.vx[from];
+    table.vy[to] = table.vy[from];
+    table.gravity[to] = table.gravity[from];
+    table.width[to] = table.width[from];
+    table.height[to] = table.height[from];
+    table.health[to] = table.health[from];
+    table.weapon[to] = table.weapon[from];
+    table.armor[to] = table.armor[from];
+    table.age[to] = table.age[from];
+    table.lifespan[to] = table.lifespan[from];
+    table.subtype[to] = table.subtype[from];
+    table.owner[to] = table.owner[from];
+    table.flags[to] = table.flags[from];
+    table.proxy[to] = table.proxy[from];
+
+    entitySlots[table.id[to].slot].row = to;
+}
+
+EntityId EntityRegistry::create(EntityKind kind)
+{
+    quint32 slot;
+    if (!freeSlots.isEmpty())
+    {
+        slot = freeSlots.takeLast();
+    }
+    else
+    {
+        slot = entitySlots.size();
+        entitySlots.append(Slot());
+    }
+
+    EntityTable &entities = table(kind);
+    int row = entities.size();
+    resizeRows(entities, row + 1);
+
+    Slot &entry = entitySlots[slot];
+    entry.kind = kind;
+    entry.row = row;
+    entry.alive = true;
+
+    EntityId id;
+    id.slot = slot;
+    id.generation = entry.generation;
+
+    // 新行的所有组件写入初始值
+    entities.id[row] = id;
+    entities.x[row] = 0;
+    entities.y[row] = 0;
+    entities.prevX[row] = 0;
+    entities.prevY[row] = 0;
+    entities.vx[row] = 0;
+    entities.vy[row] = 0;
+    entities.gravity[row] = 0;
+    entities.width[row] = 0;
+    entities.height[row] = 0;
+    entities.health[row] = 0;
+    entities.weapon[row] = Weapon();
+    entities.armor[row] = Armor();
+    entities.age[row] = 0;
+    entities.lifespan[row] = 0;
+    entities.subtype[row] = 0;
+    entities.owner[row] = 0;
+    entities.flags[row] = 0;
+    entities.proxy[row] = nullptr;
+    return id;
+}
+
+void EntityRegistry::destroy(EntityId id)
+{
+    if (!isAlive(id))
+        return;
+    const Slot &entry = entitySlots[id.slot];
+    destroyRow(entry.kind, entry.row);
+}
+
+void EntityRegistry::destroyRow(EntityKind kind, int row)
+{
+    EntityTable &entities = table(kind);
+
+    delete entities.proxy[row];     // 删除场景项时会自动从场景中移除
+
+    Slot &entry = entitySlots[entities.id[row].slot];
+    entry.alive = false;
+    entry.row = -1;
+    entry.generation++;
+    freeSlots.append(entities.id[row].slot);
+
+    // 交换后弹出
+    int last = entities.size() - 1;
+    if (row != last)
+        moveRow(entities, last, row);
+    resizeRows(entities, last);
+}
+
+void EntityRegistry::clear()
+{
+    for (int kind = 0; kind < ENTITY_KIND_COUNT; kind++)
+    {
+        EntityTable &entities = tables[kind];
+        while (entities.size() > 0)
+        {
+            destroyRow(EntityKind(kind), entities.size() - 1);
+        }
+    }
+}
+
+bool EntityRegistry::isAlive(EntityId id) const
+{
+    return !id.isNull() && int(id.slot) < entitySlots.size() &&
+           entitySlots[id.slot].alive && entitySlots[id.slot].generation == id.generation;
+}
+
+int EntityRegistry::rowOf(EntityId id) const
+{
+    return isAlive(id) ? entitySlots[id.slot].row : -1;
+}
+
+void EntityRegistry::savePreviousPositions()
+{
+    // 逐元素复制到已有的数组里，直接赋值会共享数据，之后写入时又要整块复制
+    for (EntityTable &entities : tables)
+    {
+        std::copy(entities.x.constBegin(), entities.x.constEnd(), entities.prevX.begin());
+        std::copy(entities.y.constBegin(), entities.y.constEnd(), entities.prevY.begin());
+    }
+}
+
+bool EntityRegistry::collide(EntityKind kindA, int rowA, EntityKind kindB, int rowB) const
+{
+    const EntityTable &a = table(kindA);
+    const EntityTable &b = table(kindB);
+    if (!aabbOverlap(a.bounds(rowA), b.bounds(rowB)))
+        return false;
+
+    // 非矩形实体可以选择用渲染代理的形状精确检测
+    bool exact = a.hasFlag(rowA, ENTITY_EXACT_SHAPE) || b.hasFlag(rowB, ENTITY_EXACT_SHAPE);
+    if (exact && a.proxy[rowA] && b.proxy[rowB])
+        return a.proxy[rowA]->collidesWithItem(b.proxy[rowB]);
+    return true;
+}
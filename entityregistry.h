@@ -0,0 +1,145 @@
+#ifndef ENTITYREGISTRY_H
+#define ENTITYREGISTRY_H
+
+#include <QVector>
+#include <QRectF>
+#include <QPointF>
+#include "weapon.h"
+#include "armor.h"
+
+class QGraphicsItem;
+
+// 实体种类，每种实体单独一张表
+enum class EntityKind : quint8 {
+    PLAYER,
+    ITEM,
+    PLATFORM,
+    PROJECTILE
+};
+
+const int ENTITY_KIND_COUNT = 4;
+
+// 实体的状态标志位
+enum EntityFlag : quint8 {
+    ENTITY_ON_GROUND    = 1 << 0, // 玩家站在平台上；物品落地后休眠
+    ENTITY_CROUCHING    = 1 << 1,
+    ENTITY_FACING_RIGHT = 1 << 2,
+    ENTITY_HIDDEN       = 1 << 3, // 在草地上下蹲隐身
+    ENTITY_EXPIRED      = 1 << 4, // 投射物超过寿命，等待回收
+    ENTITY_EXACT_SHAPE  = 1 << 5  // 碰撞时在AABB之后再用渲染代理的形状精确检测
+};
+
+// 实体ID：槽位加世代，实体删除后旧的ID不会再指向别的实体
+struct EntityId
+{
+    quint32 slot = 0xFFFFFFFF;
+    quint32 generation = 0;
+
+    bool isNull() const { return slot == 0xFFFFFFFF; }
+    bool operator==(const EntityId &other) const { return slot == other.slot && generation == other.generation; }
+    bool operator!=(const EntityId &other) const { return !(*this == other); }
+};
+
+// 同一种实体的全部组件，每个字段一列连续存放，第row行就是这种实体的第row个
+// 删除时把最后一行换到被删的位置，各列始终紧凑，系统可以直接线性遍历
+// 某种实体用不到的列保持为0
+struct EntityTable
+{
+    QVector<EntityId> id;
+
+    // 变换：当前位置和上一帧位置（左上角）
+    QVector<double> x;
+    QVector<double> y;
+    QVector<double> prevX;
+    QVector<double> prevY;
+
+    // 速度和重力加速度（像素/60Hz帧）
+    QVector<double> vx;
+    QVector<double> vy;
+    QVector<double> gravity;
+
+    // AABB尺寸
+    QVector<double> width;
+    QVector<double> height;
+
+    // 生命值，投射物用它保存伤害
+    QVector<int> health;
+
+    // 装备，按值存放，没有护甲时类型为ArmorType::NONE
+    QVector<Weapon> weapon;
+    QVector<Armor> armor;
+
+    // 寿命（按60Hz帧计算，lifespan小于等于0表示不会到期）
+    QVector<double> age;
+    QVector<double> lifespan;
+
+    // 种类相关的子类型（物品类型、平台类型、投射物类型）、所属玩家和标志位
+    QVector<int> subtype;
+    QVector<int> owner;
+    QVector<quint8> flags;
+
+    // 渲染代理，无界面模式下为nullptr
+    QVector<QGraphicsItem*> proxy;
+
+    int size() const { return id.size(); }
+    QPointF position(int row) const { return QPointF(x[row], y[row]); }
+    QPointF previousPosition(int row) const { return QPointF(prevX[row], prevY[row]); }
+    QRectF bounds(int row) const { return QRectF(x[row], y[row], width[row], height[row]); }
+    bool hasFlag(int row, EntityFlag flag) const { return (flags[row] & flag) != 0; }
+    void setFlag(int row, EntityFlag flag, bool on)
+    {
+        if (on)
+            flags[row] |= flag;
+        else
+            flags[row] &= ~flag;
+    }
+};
+
+// 实体注册表：拥有所有实体的组件数据，Qt场景项只是可选的渲染代理
+// 注册表拥有每个实体的渲染代理，删除实体时一起删除
+class EntityRegistry
+{
+public:
+    EntityRegistry();
+    ~EntityRegistry();
+
+    // 在对应种类的表末尾新增一行，所有组件清零
+    EntityId create(EntityKind kind);
+
+    // 删除实体，表中最后一行会移到被删的位置
+    void destroy(EntityId id);
+    void destroyRow(EntityKind kind, int row);
+
+    // 删除所有实体
+    void clear();
+
+    bool isAlive(EntityId id) const;
+    int rowOf(EntityId id) const;
+
+    EntityTable &table(EntityKind kind) { return tables[int(kind)]; }
+    const EntityTable &table(EntityKind kind) const { return tables[int(kind)]; }
+
+    // 记录所有实体本帧开始时的位置，用于扫掠检测和渲染插值
+    void savePreviousPositions();
+
+    // 两个实体是否碰撞：比较AABB；任一方带ENTITY_EXACT_SHAPE标志且都有渲染代理时再比较形状
+    bool collide(EntityKind kindA, int rowA, EntityKind kindB, int rowB) const;
+
+private:
+    struct Slot
+    {
+        EntityKind kind = EntityKind::PLAYER;
+        int row = -1;
+        quint32 generation = 0;
+        bool alive = false;
+    };
+
+    void resizeRows(EntityTable &table, int count);
+    void moveRow(EntityTable &table, int from, int to);
+
+    EntityTable tables[ENTITY_KIND_COUNT];
+    QVector<Slot> entitySlots;
+    QVector<quint32> freeSlots;
+};
+
+#endif // ENTITYREGISTRY_H
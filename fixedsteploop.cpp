@@ -0,0 +1,57 @@
+#include "fixedsteploop.h"
+
+FixedStepLoop::FixedStepLoop(int tickRate)
+    : lastTime(0), accumulator(0), tickNanos(0), droppedNanos(0), tickRate(60), maxSteps(8)
+{
+    setTickRate(tickRate);
+}
+
+void FixedStepLoop::setTickRate(int hz)
+{
+    tickRate = roundTickRate(hz);
+    tickNanos = 1000000000LL / tickRate;
+}
+
+void FixedStepLoop::start()
+{
+    clock.start();
+    lastTime = 0;
+    accumulator = 0;
+    droppedNanos = 0;
+}
+
+int FixedStepLoop::advance()
+{
+    qint64 now = clock.nsecsElapsed();
+    accumulator += now - lastTime;
+    lastTime = now;
+
+    int steps = int(accumulator / tickNanos);
+    if (steps > maxSteps)
+    {
+        // 机器跑不动了，丢弃多余的时间，宁可变慢也不要卡死
+        droppedNanos += (steps - maxSteps) * tickNanos;
+        steps = maxSteps;
+    }
+    accumulator -= steps * tickNanos;
+    if (accumulator >= tickNanos)
+    {
+        accumulator %= tickNanos;
+    }
+    return steps;
+}
+
+double FixedStepLoop::getAlpha() const
+{
+    return double(accumulator) / double(tickNanos);
+}
+
+double FixedStepLoop::getLagMs() const
+{
+    return accumulator / 1000000.0;
+}
+
+double FixedStepLoop::getDroppedMs() const
+{
+    return droppedNanos / 1000000.0;
+}
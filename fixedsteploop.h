@@ -0,0 +1,43 @@
+#ifndef FIXEDSTEPLOOP_H
+#define FIXEDSTEPLOOP_H
+
+#include <QElapsedTimer>
+#include "tickrate.h"
+
+// 固定步长循环：按真实经过的时间累积，换算成需要推进的逻辑帧数
+// 逻辑帧率与渲染帧率无关，渲染时用getAlpha()在最近两帧之间插值
+class FixedStepLoop
+{
+public:
+    explicit FixedStepLoop(int tickRate = 60);
+
+    // 逻辑帧率，按roundTickRate()取整
+    void setTickRate(int hz);
+    int getTickRate() const { return tickRate; }
+
+    // 重新开始计时，清空累积时间
+    void start();
+
+    // 返回本次需要推进的帧数；落后太多时丢弃多余时间，避免越追越慢
+    int advance();
+
+    // 渲染插值系数：0表示上一帧，1表示当前帧
+    double getAlpha() const;
+
+    // 还没模拟的时间（毫秒），正常情况下小于一帧
+    double getLagMs() const;
+
+    // 因为追不上而丢弃的时间累计（毫秒），大于0说明机器跑不动当前帧率
+    double getDroppedMs() const;
+
+private:
+    QElapsedTimer clock;
+    qint64 lastTime;
+    qint64 accumulator;
+    qint64 tickNanos;
+    qint64 droppedNanos;
+    int tickRate;
+    int maxSteps;               // 每次advance()最多推进的帧数
+};
+
+#endif // FIXEDSTEPLOOP_H
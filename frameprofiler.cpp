@@ -0,0 +1,259 @@
+#include "frameprofiler.h"
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QPainter>
+
+FrameProfiler::FrameProfiler()
+    : started(false), overlayVisible(false), written(0)
+{
+    clock.start();
+}
+
+void FrameProfiler::nextFrame()
+{
+    qint64 time = now();
+    if (started)
+    {
+        // 先写数据，再发布计数，读取方看到计数时这一帧已经完整
+        current.frameNs = time - current.startNs;
+        quint64 index = written.loadRelaxed();
+        ring[index % CAPACITY] = current;
+        written.storeRelease(index + 1);
+    }
+
+    current = FrameSample();
+    current.startNs = time;
+    started = true;
+}
+
+void FrameProfiler::addPhase(int phase, qint64 startNs, qint64 durationNs)
+{
+    if (current.phaseNs[phase] == 0)
+        current.phaseStartNs[phase] = startNs;
+    current.phaseNs[phase] += durationNs;
+}
+
+void FrameProfiler::addSimulation(const SimWorld &world, qint64 startNs, int ticks)
+{
+    current.ticks += ticks;
+
+    // 逻辑帧内各阶段交替执行，这里只有总耗时，按阶段顺序依次排开
+    qint64 offset = startNs;
+    for (int i = 0; i < SIM_PHASE_COUNT; i++)
+    {
+        qint64 total = world.getPhaseNanos(i);
+        // 计时被重置过时从0开始算
+        qint64 delta = total >= lastSimNanos[i] ? total - lastSimNanos[i] : total;
+        lastSimNanos[i] = total;
+        if (delta > 0)
+        {
+            addPhase(i, offset, delta);
+            offset += delta;
+        }
+    }
+}
+
+void FrameProfiler::setEntityCounts(const EntityRegistry &registry)
+{
+    for (int i = 0; i < ENTITY_KIND_COUNT; i++)
+    {
+        current.entities[i] = registry.table(EntityKind(i)).size();
+    }
+}
+
+void FrameProfiler::setLoopState(const FixedStepLoop &loop)
+{
+    current.lagMs = loop.getLagMs();
+    current.droppedMs = loop.getDroppedMs();
+}
+
+QVector<FrameSample> FrameProfiler::recentFrames(int count) const
+{
+    quint64 end = written.loadAcquire();
+    quint64 available = qMin<quint64>(end, CAPACITY);
+    quint64 first = end - qMin<quint64>(available, quint64(qMax(0, count)));
+
+    QVector<FrameSample> frames;
+    frames.reserve(int(end - first));
+    for (quint64 i = first; i < end; i++)
+    {
+        frames.append(ring[i % CAPACITY]);
+    }
+
+    // 复制期间写入方可能已经绕回来覆盖了最旧的几帧（包括正在写的那一格），丢掉它们
+    quint64 after = written.loadAcquire() + 1;
+    if (after > first + CAPACITY)
+    {
+        int overwritten = int(qMin<quint64>(after - first - CAPACITY, quint64(frames.size())));
+        frames.remove(0, overwritten);
+    }
+    return frames;
+}
+
+bool FrameProfiler::exportChromeTrace(const QString &path, QString *error) const
+{
+    QVector<FrameSample> frames = recentFrames(CAPACITY);
+
+    // 每帧一个“frame”事件，阶段作为其中的子事件；时间单位为微秒
+    QJsonArray events;
+    for (const FrameSample &frame : frames)
+    {
+        QJsonObject event;
+        event.insert("name", "frame");
+        event.insert("ph", "X");
+        event.insert("pid", 1);
+        event.insert("tid", 1);
+        event.insert("ts", frame.startNs / 1000.0);
+        event.insert("dur", frame.frameNs / 1000.0);
+        QJsonObject args;
+        args.insert("ticks", frame.ticks);
+        args.insert("players", frame.entities[int(EntityKind::PLAYER)]);
+        args.insert("items", frame.entities[int(EntityKind::ITEM)]);
+        args.insert("projectiles", frame.entities[int(EntityKind::PROJECTILE)]);
+        args.insert("lag_ms", frame.lagMs);
+        args.insert("dropped_ms", frame.droppedMs);
+        event.insert("args", args);
+        events.append(event);
+
+        for (int phase = 0; phase < PROFILE_PHASE_COUNT; phase++)
+        {
+            if (frame.phaseNs[phase] <= 0)
+                continue;
+            QJsonObject phaseEvent;
+            phaseEvent.insert("name", phaseName(phase));
+            phaseEvent.insert("ph", "X");
+            phaseEvent.insert("pid", 1);
+            phaseEvent.insert("tid", 1);
+            phaseEvent.insert("ts", frame.phaseStartNs[phase] / 1000.0);
+            phaseEvent.insert("dur", frame.phaseNs[phase] / 1000.0);
+            events.append(phaseEvent);
+        }
+    }
+
+    QJsonObject root;
+    root.insert("traceEvents", events);
+    root.insert("displayTimeUnit", "ms");
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        if (error)
+            *error = file.errorString();
+        return false;
+    }
+    if (file.write(QJsonDocument(root).toJson(QJsonDocument::Compact)) < 0)
+    {
+        if (error)
+            *error = file.errorString();
+        return false;
+    }
+    return true;
+}
+
+QRectF FrameProfiler::overlayRect(int sceneWidth)
+{
+    // 放在两侧信息栏之间
+    return QRectF(sceneWidth / 2 - 170, 20, 340, 230);
+}
+
+void FrameProfiler::drawOverlay(QPainter *painter, const QRectF &area) const
+{
+    const int HISTORY = 120;        // 直方图显示的帧数
+    const int AVERAGE = 60;         // 各阶段耗时取平均的帧数
+    const qreal FULL_SCALE_MS = 33.3;
+    const qreal BUDGET_MS = 1000.0 / 60;
+
+    QVector<FrameSample> frames = recentFrames(HISTORY);
+
+    painter->save();
+    painter->setOpacity(1.0);
+    painter->setPen(Qt::NoPen);
+    painter->setBrush(QColor(0, 0, 0, 180));
+    painter->drawRect(area);
+
+    // 帧时间直方图，超出16.7ms预算的帧标红
+    QRectF chart(area.left() + 10, area.top() + 10, area.width() - 20, 60);
+    qreal barWidth = chart.width() / HISTORY;
+    int offset = HISTORY - frames.size();
+    for (int i = 0; i < frames.size(); i++)
+    {
+        qreal ms = frames[i].frameNs / 1e6;
+        qreal height = qMin(ms / FULL_SCALE_MS, 1.0) * chart.height();
+        painter->setBrush(ms > BUDGET_MS ? QColor(230, 60, 60) : QColor(80, 200, 120));
+        painter->drawRect(QRectF(chart.left() + (offset + i) * barWidth, chart.bottom() - height,
+                                 qMax<qreal>(barWidth - 1, 1), height));
+    }
+    qreal budgetY = chart.bottom() - BUDGET_MS / FULL_SCALE_MS * chart.height();
+    painter->setPen(QColor(255, 255, 255, 120));
+    painter->drawLine(QPointF(chart.left(), budgetY), QPointF(chart.right(), budgetY));
+
+    // 最近若干帧各阶段的平均耗时
+    qreal phaseMs[PROFILE_PHASE_COUNT] = {};
+    qreal frameMs = 0;
+    int averaged = qMin(frames.size(), AVERAGE);
+    for (int i = frames.size() - averaged; i < frames.size(); i++)
+    {
+        frameMs += frames[i].frameNs / 1e6;
+        for (int phase = 0; phase < PROFILE_PHASE_COUNT; phase++)
+            phaseMs[phase] += frames[i].phaseNs[phase] / 1e6;
+    }
+
+    QFont font = painter->font();
+    font.setPixelSize(12);
+    painter->setFont(font);
+    painter->setPen(Qt::white);
+
+    qreal x = area.left() + 10;
+    qreal y = chart.bottom() + 18;
+    int divisor = qMax(1, averaged);
+    painter->drawText(QPointF(x, y), QString("帧 %1 ms").arg(frameMs / divisor, 0, 'f', 2));
+    if (!frames.isEmpty())
+    {
+        // 丢弃时间一直增长说明机器跑不动当前的逻辑帧率，标红
+        const FrameSample &last = frames.last();
+        painter->setPen(last.droppedMs > frames.first().droppedMs ? QColor(230, 60, 60) : QColor(Qt::white));
+        painter->drawText(QPointF(x + area.width() / 2 - 10, y),
+                          QString("积压 %1 ms  丢弃 %2 ms").arg(last.lagMs, 0, 'f', 2).arg(last.droppedMs, 0, 'f', 0));
+        painter->setPen(Qt::white);
+    }
+    for (int phase = 0; phase < PROFILE_PHASE_COUNT; phase++)
+    {
+        // 两列排开
+        qreal column = phase % 2 == 0 ? 0 : area.width() / 2 - 10;
+        qreal row = y + 16 * (1 + phase / 2);
+        painter->drawText(QPointF(x + column, row),
+                          QString("%1 %2 ms").arg(phaseName(phase)).arg(phaseMs[phase] / divisor, 0, 'f', 3));
+    }
+
+    if (!frames.isEmpty())
+    {
+        const FrameSample &last = frames.last();
+        painter->drawText(QPointF(x, area.bottom() - 10),
+                          QString("玩家 %1  物品 %2  投射物 %3  平台 %4")
+                              .arg(last.entities[int(EntityKind::PLAYER)])
+                              .arg(last.entities[int(EntityKind::ITEM)])
+                              .arg(last.entities[int(EntityKind::PROJECTILE)])
+                              .arg(last.entities[int(EntityKind::PLATFORM)]));
+    }
+    painter->restore();
+}
+
+const char *FrameProfiler::phaseName(int phase)
+{
+    if (phase < SIM_PHASE_COUNT)
+        return SimWorld::phaseName(phase);
+
+    switch (phase)
+    {
+    case PROFILE_SYNC:
+        return "sync";
+    case PROFILE_HUD:
+        return "hud";
+    case PROFILE_PAINT:
+        return "paint";
+    default:
+        return "unknown";
+    }
+}
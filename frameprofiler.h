@@ -0,0 +1,106 @@
+#ifndef FRAMEPROFILER_H
+#define FRAMEPROFILER_H
+
+#include <QAtomicInteger>
+#include <QElapsedTimer>
+#include <QRectF>
+#include <QString>
+#include <QVector>
+#include "simworld.h"
+#include "fixedsteploop.h"
+
+class QPainter;
+
+// 一帧中统计耗时的阶段：前面几项与SimPhase一一对应，由游戏世界的分阶段计时换算而来，
+// 后面几项是界面线程上的工作
+enum ProfilePhase {
+    PROFILE_SYNC = SIM_PHASE_COUNT,   // 同步渲染代理
+    PROFILE_HUD,                      // 更新信息栏（renderInfo）
+    PROFILE_PAINT,                    // 绘制场景或批量渲染
+    PROFILE_PHASE_COUNT
+};
+
+// 一个渲染帧的统计（时间单位为纳秒，从分析器创建时开始计）
+struct FrameSample
+{
+    qint64 startNs = 0;
+    qint64 frameNs = 0;                             // 到下一帧开始为止
+    int ticks = 0;                                  // 本帧推进的逻辑帧数
+    qint64 phaseStartNs[PROFILE_PHASE_COUNT] = {};  // 本帧中第一次进入该阶段的时间
+    qint64 phaseNs[PROFILE_PHASE_COUNT] = {};       // 本帧中该阶段的总耗时
+    int entities[ENTITY_KIND_COUNT] = {};           // 帧末各种实体的数量
+    double lagMs = 0;                               // 帧末固定步长循环中还没模拟的时间
+    double droppedMs = 0;                           // 到帧末为止因为追不上而丢弃的时间
+};
+
+// 帧分析器：界面线程每帧写入一条FrameSample，保存在固定大小的环形缓冲区中，
+// 写入不加锁，只在写完后用release语义发布计数，读取方（叠加层、导出）可以在任何线程读，
+// 读完再检查这段是否已被覆盖，被覆盖的旧帧直接丢弃
+// 同一帧中多个逻辑帧的同一阶段合并为一段，导出时按阶段顺序依次排开
+class FrameProfiler
+{
+public:
+    // 环形缓冲区的容量，约17秒（60FPS）
+    static const int CAPACITY = 1024;
+
+    FrameProfiler();
+
+    // 结束上一帧并把它写入缓冲区，开始新的一帧
+    void nextFrame();
+
+    // 计时的当前时间
+    qint64 now() const { return clock.nsecsElapsed(); }
+
+    // 把一段耗时计入当前帧的某个阶段
+    void addPhase(int phase, qint64 startNs, qint64 durationNs);
+
+    // 读取游戏世界的分阶段计时，把从上次读取以来的增量计入当前帧，
+    // startNs为本帧开始推进逻辑帧的时间
+    void addSimulation(const SimWorld &world, qint64 startNs, int ticks);
+
+    // 记录当前帧末尾的实体数量
+    void setEntityCounts(const EntityRegistry &registry);
+
+    // 记录当前帧末尾固定步长循环的积压和丢弃时间
+    void setLoopState(const FixedStepLoop &loop);
+
+    // 最近最多count帧，按时间顺序排列
+    QVector<FrameSample> recentFrames(int count) const;
+
+    // 把缓冲区中的所有帧导出为Chrome trace JSON（chrome://tracing或Perfetto可以打开）
+    bool exportChromeTrace(const QString &path, QString *error = nullptr) const;
+
+    // 叠加层：帧时间直方图、各阶段耗时、循环的积压和丢弃时间、实体数量
+    void setOverlayVisible(bool visible) { overlayVisible = visible; }
+    bool isOverlayVisible() const { return overlayVisible; }
+    static QRectF overlayRect(int sceneWidth);
+    void drawOverlay(QPainter *painter, const QRectF &area) const;
+
+    static const char *phaseName(int phase);
+
+private:
+    QElapsedTimer clock;
+    FrameSample current;
+    qint64 lastSimNanos[SIM_PHASE_COUNT] = {};
+    bool started;
+    bool overlayVisible;
+
+    FrameSample ring[CAPACITY];
+    QAtomicInteger<quint64> written;    // 已写入的总帧数
+};
+
+// 作用域计时：构造时记下时间，析构时计入当前帧的对应阶段
+class ProfileScope
+{
+public:
+    ProfileScope(FrameProfiler &profiler, ProfilePhase phase)
+        : profiler(profiler), phase(phase), start(profiler.now()) {}
+    ~ProfileScope() { profiler.addPhase(phase, start, profiler.now() - start); }
+
+private:
+    FrameProfiler &profiler;
+    ProfilePhase phase;
+    qint64 start;
+};
+
+#endif // FRAMEPROFILER_H
@@ -0,0 +1,199 @@
+#ifndef GAMEDATA_H
+#define GAMEDATA_H
+
+#include <QtGlobal>
+
+// 武器、投射物、护甲和物品的类型及其数值表
+// 每种类型的全部数值都在对应表的一行里，按枚举值下标直接查表，热路径上不需要switch
+// 新增一种类型只需要在枚举和表中各加一行，下面的static_assert会检查两者的顺序是否一致
+
+enum class ProjectileType {
+    MELEE,
+    BALL,
+    BULLET
+};
+
+enum class WeaponType {
+    FIST,
+    KNIFE,
+    BALL,
+    RIFLE,
+    SNIPER
+};
+
+enum class ArmorType {
+    NONE,
+    LIGHT,  // 轻甲
+    BULLETPROOF  // 防弹衣
+};
+
+enum class ItemType {
+    KNIFE,
+    BALL,
+    RIFLE,
+    SNIPER,
+    BANDAGE,
+    MEDKIT,
+    ADRENALINE,
+    LIGHT_ARMOR,    // 新增 - 轻甲
+    BULLETPROOF_VEST // 新增 - 防弹衣
+};
+
+// 持续一段时间的状态效果
+enum class StatusEffectType {
+    NONE,
+    ADRENALINE      // 肾上腺素：加速并每秒回血
+};
+
+const int PROJECTILE_TYPE_COUNT = 3;
+const int WEAPON_TYPE_COUNT = 5;
+const int ARMOR_TYPE_COUNT = 3;
+const int ITEM_TYPE_COUNT = 9;
+const int STATUS_EFFECT_TYPE_COUNT = 2;
+
+// 投射物：碰撞箱尺寸和运动方式（速度单位为像素/60Hz帧）
+struct ProjectileStats
+{
+    ProjectileType type;
+    qreal width;
+    qreal height;
+    qreal gravity;          // 每帧的重力加速度，只有实心球受重力
+    qreal lift;             // 发射时向上的速度与水平速度之比
+    bool hitsPlatforms;     // 是否会被平台挡住（近战攻击不会）
+};
+
+constexpr ProjectileStats PROJECTILE_STATS[PROJECTILE_TYPE_COUNT] = {
+    // 类型                   宽   高   重力  上抛  被平台挡住
+    {ProjectileType::MELEE,  30, 10, 0.0, 0.0, false},
+    {ProjectileType::BALL,   20, 20, 0.1, 0.8, true},   // 抛物线运动
+    {ProjectileType::BULLET, 15,  7, 0.0, 0.0, true},
+};
+
+// 武器：弹药（-1为无限）、伤害、冷却时间（模拟时间，毫秒）和发射的投射物
+// 投射物寿命按60Hz帧计算，AI按攻击距离决定何时开火
+struct WeaponStats
+{
+    WeaponType type;
+    const char *name;       // UTF-8显示名称
+    int ammo;
+    int damage;
+    int cooldownMs;
+    ProjectileType projectile;
+    qreal speed;
+    int lifespan;
+    int attackRange;
+};
+
+constexpr WeaponStats WEAPON_STATS[WEAPON_TYPE_COUNT] = {
+    // 类型               名称       弹药 伤害 冷却  投射物                  速度 寿命 攻击距离
+    {WeaponType::FIST,   "拳头",     -1,  5,  500, ProjectileType::MELEE,  10,  20,  50},
+    {WeaponType::KNIFE,  "小刀",     -1, 10,  300, ProjectileType::MELEE,  12,  20,  70},
+    {WeaponType::BALL,   "实心球",    5, 15, 1000, ProjectileType::BALL,    8, 100, 200},
+    {WeaponType::RIFLE,  "步枪",     20, 18,  200, ProjectileType::BULLET, 15,  80, 300},
+    {WeaponType::SNIPER, "狙击枪",    5, 30, 1500, ProjectileType::BULLET, 20,  80, 500},
+};
+
+// 护甲：对每种投射物吸收的伤害比例，以及完全免疫的伤害上限
+// 会磨损的护甲按吸收的伤害扣除耐久度，耐久度用完即损坏
+struct ArmorStats
+{
+    ArmorType type;
+    const char *name;
+    int durability;
+    bool wears;
+    double absorb[PROJECTILE_TYPE_COUNT];           // 按近战、实心球、子弹的顺序
+    int immuneUpTo[PROJECTILE_TYPE_COUNT];          // 伤害不超过该值时完全免疫
+};
+
+constexpr ArmorStats ARMOR_STATS[ARMOR_TYPE_COUNT] = {
+    {ArmorType::NONE,        "无",     0,   false, {0.0, 0.0, 0.0}, {0, 0, 0}},
+    // 轻甲：完全免疫拳头伤害，小刀伤害减半，不消耗耐久度
+    {ArmorType::LIGHT,       "轻甲",   100, false, {0.5, 0.0, 0.0}, {5, 0, 0}},
+    // 防弹衣：吸收70%的子弹伤害
+    {ArmorType::BULLETPROOF, "防弹衣", 100, true,  {0.0, 0.0, 0.7}, {0, 0, 0}},
+};
+
+// 状态效果：持续时间和周期（模拟时间，毫秒），每个周期回复的生命值和移动速度倍率
+// 同一玩家再次获得同种效果时重新计时
+struct StatusEffectStats
+{
+    StatusEffectType type;
+    int durationMs;
+    int periodMs;           // 0表示没有周期效果
+    int healPerPeriod;
+    qreal speedMultiplier;
+};
+
+constexpr StatusEffectStats STATUS_EFFECT_STATS[STATUS_EFFECT_TYPE_COUNT] = {
+    // 类型                          持续   周期  回血 速度倍率
+    {StatusEffectType::NONE,         0,     0,    0,   1.0},
+    {StatusEffectType::ADRENALINE,   10000, 1000, 1,   1.5},
+};
+
+// 物品：外观、生成权重、拾取效果和AI的评分
+// AI在自己的生命值低于urgentHealth时使用urgentScore（0表示不区分）
+struct ItemStats
+{
+    ItemType type;
+    const char *label;
+    int red;
+    int green;
+    int blue;
+    int spawnWeight;
+    bool givesWeapon;
+    WeaponType weapon;
+    int heal;               // 回复的生命值，上限为100
+    ArmorType armor;
+    StatusEffectType effect;
+    int aiScore;
+    int aiUrgentScore;
+    int aiUrgentHealth;
+};
+
+constexpr ItemStats ITEM_STATS[ITEM_TYPE_COUNT] = {
+    // 类型                       标签          颜色           权重 武器                          回血 护甲                    状态效果                     AI评分
+    {ItemType::KNIFE,            "小刀",       200, 200, 200, 10, true,  WeaponType::KNIFE,  0,   ArmorType::NONE,        StatusEffectType::NONE,       30, 0,  0},
+    {ItemType::BALL,             "实心球",      50,  50,  50, 10, true,  WeaponType::BALL,   0,   ArmorType::NONE,        StatusEffectType::NONE,       60, 0,  0},
+    {ItemType::RIFLE,            "步枪",       100, 100, 100, 10, true,  WeaponType::RIFLE,  0,   ArmorType::NONE,        StatusEffectType::NONE,       80, 0,  0},
+    {ItemType::SNIPER,           "狙击枪",      70,  70,  70, 10, true,  WeaponType::SNIPER, 0,   ArmorType::NONE,        StatusEffectType::NONE,       90, 0,  0},
+    {ItemType::BANDAGE,          "绷带+25",    255, 255, 255, 15, false, WeaponType::FIST,   25,  ArmorType::NONE,        StatusEffectType::NONE,       20, 40, 50},
+    {ItemType::MEDKIT,           "医疗箱+100", 255,   0,   0, 10, false, WeaponType::FIST,   100, ArmorType::NONE,        StatusEffectType::NONE,       40, 85, 30},
+    {ItemType::ADRENALINE,       "肾上腺素",   255, 255,   0, 10, false, WeaponType::FIST,   0,   ArmorType::NONE,        StatusEffectType::ADRENALINE, 65, 0,  0},
+    {ItemType::LIGHT_ARMOR,      "轻甲",       100, 100, 255, 12, false, WeaponType::FIST,   0,   ArmorType::LIGHT,       StatusEffectType::NONE,       50, 0,  0},
+    {ItemType::BULLETPROOF_VEST, "防弹衣",      50, 150,  50, 13, false, WeaponType::FIST,   0,   ArmorType::BULLETPROOF, StatusEffectType::NONE,       70, 0,  0},
+};
+
+constexpr const ProjectileStats &projectileStats(ProjectileType type) { return PROJECTILE_STATS[int(type)]; }
+constexpr const WeaponStats &weaponStats(WeaponType type) { return WEAPON_STATS[int(type)]; }
+constexpr const ArmorStats &armorStats(ArmorType type) { return ARMOR_STATS[int(type)]; }
+constexpr const ItemStats &itemStats(ItemType type) { return ITEM_STATS[int(type)]; }
+constexpr const StatusEffectStats &statusEffectStats(StatusEffectType type) { return STATUS_EFFECT_STATS[int(type)]; }
+
+// 所有物品的生成权重之和，生成物品时在[0, 总和)中取随机数
+constexpr int itemSpawnWeightTotal()
+{
+    int total = 0;
+    for (const ItemStats &stats : ITEM_STATS)
+        total += stats.spawnWeight;
+    return total;
+}
+
+// 编译期检查每张表的行顺序与枚举一致
+template <typename Stats, int N>
+constexpr bool tableMatchesEnum(const Stats (&table)[N])
+{
+    for (int i = 0; i < N; i++)
+    {
+        if (int(table[i].type) != i)
+            return false;
+    }
+    return true;
+}
+
+static_assert(tableMatchesEnum(PROJECTILE_STATS), "PROJECTILE_STATS的顺序必须与ProjectileType一致");
+static_assert(tableMatchesEnum(WEAPON_STATS), "WEAPON_STATS的顺序必须与WeaponType一致");
+static_assert(tableMatchesEnum(ARMOR_STATS), "ARMOR_STATS的顺序必须与ArmorType一致");
+static_assert(tableMatchesEnum(ITEM_STATS), "ITEM_STATS的顺序必须与ItemType一致");
+static_assert(tableMatchesEnum(STATUS_EFFECT_STATS), "STATUS_EFFECT_STATS的顺序必须与StatusEffectType一致");
+
+#endif // GAMEDATA_H
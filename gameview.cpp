@@ -0,0 +1,23 @@
+#include "gameview.h"
+#include <QPainter>
+
+GameView::GameView(QGraphicsScene *scene, FrameProfiler *profiler, QWidget *parent)
+    : QGraphicsView(scene, parent), profiler(profiler)
+{
+}
+
+void GameView::paintEvent(QPaintEvent *event)
+{
+    ProfileScope scope(*profiler, PROFILE_PAINT);
+    QGraphicsView::paintEvent(event);
+}
+
+void GameView::drawForeground(QPainter *painter, const QRectF &rect)
+{
+    QGraphicsView::drawForeground(painter, rect);
+
+    // 视图没有缩放和滚动，场景坐标就是窗口坐标
+    QRectF area = FrameProfiler::overlayRect(int(sceneRect().width()));
+    if (profiler->isOverlayVisible() && rect.intersects(area))
+        profiler->drawOverlay(painter, area);
+}
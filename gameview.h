@@ -0,0 +1,21 @@
+#ifndef GAMEVIEW_H
+#define GAMEVIEW_H
+
+#include <QGraphicsView>
+#include "frameprofiler.h"
+
+// 场景渲染方式使用的视图：统计每次绘制场景的耗时，开启时在最上层画出帧分析叠加层
+class GameView : public QGraphicsView
+{
+public:
+    GameView(QGraphicsScene *scene, FrameProfiler *profiler, QWidget *parent = nullptr);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void drawForeground(QPainter *painter, const QRectF &rect) override;
+
+private:
+    FrameProfiler *profiler;
+};
+
+#endif // GAMEVIEW_H
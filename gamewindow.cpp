@@ -2,10 +2,13 @@
 #include <QLayout>
 #include <QFont>
 #include <QDebug>
-#include "ai.h"
+#include <QDateTime>
+#include <QMap>
+#include "assetmanager.h"
 
 GameWindow::GameWindow(QWidget *parent)
-    : QMainWindow(parent), gameRunning(false), gameMode(GameMode::PLAYER_VS_PLAYER), ai(nullptr)
+    : QMainWindow(parent), renderBackend(RenderBackend::SCENE), replaying(false),
+      tickRate(SIM_BASE_TICK_RATE), gameRunning(false), gameMode(GameMode::PLAYER_VS_PLAYER)
 {
     // 设置窗口大小
     gameWidth = 1200;
@@ -16,49 +19,86 @@ GameWindow::GameWindow(QWidget *parent)
     // 确保主窗口接收所有键盘事件
     setFocusPolicy(Qt::StrongFocus);
 
+    // 创建游戏世界
+    world = new SimWorld(gameWidth, gameHeight, this);
+    world->setRenderProxies(true);
+    world->setPhaseTiming(true);    // 帧分析器从这里读取各逻辑阶段的耗时
+    connect(world, &SimWorld::itemSpawned, this, &GameWindow::addItemToScene);
+    connect(world, &SimWorld::projectileSpawned, this, &GameWindow::addProjectileToScene);
+    connect(world, &SimWorld::gameOver, this, &GameWindow::gameOver);
+
+    preloadAssets();
     setupScene();
     createControls();
 }
 
 GameWindow::~GameWindow()
 {
-    if (ai)
-        delete ai;
+    // 先删除世界，实体析构时会自动从场景中移除
+    delete world;
     delete gameTimer;
-    delete itemTimer;
     delete scene;
-    delete view;
 }
+void GameWindow::preloadAssets()
+{
+    // 所有图片在启动时就在工作线程上解码和缩放，开始新的一局时不再读磁盘
+    AssetManager &assets = AssetManager::instance();
+    assets.preload("./images/vs.jpeg", QSize(gameWidth, gameHeight), Qt::KeepAspectRatioByExpanding);
+
+    // Platform::paint()按平台的尺寸取贴图，这里从关卡中收集每种贴图用到的所有尺寸
+    SimWorld level(gameWidth, gameHeight);
+    level.reset(GameMode::PLAYER_VS_PLAYER, 0);
+    const EntityTable &platforms = level.getRegistry().table(EntityKind::PLATFORM);
+    QMap<QString, QVector<QSize>> textureSizes;
+    for (int i = 0; i < platforms.size(); i++)
+    {
+        QString path = Platform::texturePath(PlatformType(platforms.subtype[i]));
+        textureSizes[path].append(platforms.bounds(i).size().toSize());
+    }
+    for (auto it = textureSizes.constBegin(); it != textureSizes.constEnd(); ++it)
+    {
+        assets.preload(it.key(), it.value());
+    }
+
+    assets.preload("./images/chijing.jpeg", PLAYER_IMAGE_SIZE);
+    assets.preload("./images/anshi.jpeg", PLAYER_IMAGE_SIZE);
+}
+
 #include <QMessageBox>
 void GameWindow::setupScene()
 {
     // 创建场景和视图
     scene = new QGraphicsScene(0, 0, gameWidth, gameHeight);
-    view = new QGraphicsView(scene);
+    view = new GameView(scene, &profiler);
     view->setRenderHint(QPainter::Antialiasing);
 
-    QPixmap backgroundPixmap("./images/vs.jpeg");
-    if (!backgroundPixmap.isNull())
-    {
-        // 缩放图片以适应场景大小
-        QPixmap scaledBackground = backgroundPixmap.scaled(gameWidth, gameHeight, Qt::KeepAspectRatioByExpanding, Qt::SmoothTransformation);
+    // 背景和平台合成到静态层中，平台在每局开始时加入
+    staticLayer = new StaticLayer(QSize(gameWidth, gameHeight));
+    staticLayer->setZValue(-1000); // 确保背景在最底层
+    scene->addItem(staticLayer);
 
-        // 创建背景图片项并添加到场景
-        QGraphicsPixmapItem *backgroundItem = new QGraphicsPixmapItem(scaledBackground);
-        backgroundItem->setPos(0, 0);
-        backgroundItem->setZValue(-1000); // 确保背景在最底层
-        backgroundItem->setOpacity(0.2);  // 设置背景透明度
-        scene->addItem(backgroundItem);
-        // QMessageBox::information(nullptr, "调试", "背景图片找到了: ");
-        //  设置透明背景，让图片显示
-        view->setBackgroundBrush(QBrush(Qt::transparent));
+    // 缩放到场景大小的背景图，由资源管理器预加载
+    QPixmap scaledBackground = AssetManager::instance().pixmap("./images/vs.jpeg", QSize(gameWidth, gameHeight),
+                                                               Qt::KeepAspectRatioByExpanding);
+    if (!scaledBackground.isNull())
+    {
+        // 以20%的透明度混合到视口的底色上
+        QColor baseColor = view->viewport()->palette().color(view->viewport()->backgroundRole());
+        staticLayer->setBackground(scaledBackground, 0.2, baseColor);
     }
     else
     {
-
         //  如果图片加载失败，使用默认背景色
-        view->setBackgroundBrush(QBrush(QColor(30, 30, 30)));
+        staticLayer->setBackground(QPixmap(), 1.0, QColor(30, 30, 30));
     }
+    staticLayer->rebuild(world->getRegistry().table(EntityKind::PLATFORM));
+
+    // 信息栏在最上层，开始游戏后才显示
+    hud = new Hud(gameWidth);
+    hud->setZValue(1000);
+    hud->hide();
+    scene->addItem(hud);
+
     view->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
     view->setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
     view->setFixedSize(gameWidth, gameHeight);
@@ -67,20 +107,26 @@ void GameWindow::setupScene()
     view->setFocusPolicy(Qt::StrongFocus);
     view->installEventFilter(this);
 
-    setCentralWidget(view);
+    // 批量渲染器与视图放在同一位置，同时只显示一个
+    renderer = new WorldRenderer(world, staticLayer, hud, &profiler);
+    renderer->setFixedSize(gameWidth, gameHeight);
+    renderer->installEventFilter(this);
 
-    // 设置游戏定时器
+    renderStack = new QStackedWidget;
+    renderStack->addWidget(view);
+    renderStack->addWidget(renderer);
+    renderStack->setCurrentWidget(view);
+    setCentralWidget(renderStack);
+
+    // 设置游戏定时器（渲染帧），逻辑帧数由stepLoop根据真实时间决定
     gameTimer = new QTimer(this);
+    gameTimer->setTimerType(Qt::PreciseTimer);
     connect(gameTimer, &QTimer::timeout, this, &GameWindow::updateGame);
-
-    // 设置物品生成定时器
-    itemTimer = new QTimer(this);
-    connect(itemTimer, &QTimer::timeout, this, &GameWindow::spawnItems);
 }
 
 bool GameWindow::eventFilter(QObject *obj, QEvent *event)
 {
-    if (obj == view)
+    if (obj == view || obj == renderer)
     {
         if (event->type() == QEvent::KeyPress)
         {
@@ -112,39 +158,6 @@ void GameWindow::createControls()
     aiButton->setFont(QFont("Arial", 14));
     connect(aiButton, &QPushButton::clicked, this, &GameWindow::startAIGame);
 
-    // 创建生命值显示
-    player1HealthLabel = new QLabel(this);
-    player1HealthLabel->setGeometry(20, 20, 200, 30);
-    player1HealthLabel->setStyleSheet("color: white; font-size: 18px;");
-    player1HealthLabel->hide();
-
-    player2HealthLabel = new QLabel(this);
-    player2HealthLabel->setGeometry(gameWidth - 220, 20, 200, 30);
-    player2HealthLabel->setStyleSheet("color: white; font-size: 18px;");
-    player2HealthLabel->hide();
-
-    // 创建武器显示
-    player1WeaponLabel = new QLabel(this);
-    player1WeaponLabel->setGeometry(20, 50, 200, 30);
-    player1WeaponLabel->setStyleSheet("color: white; font-size: 16px;");
-    player1WeaponLabel->hide();
-
-    player2WeaponLabel = new QLabel(this);
-    player2WeaponLabel->setGeometry(gameWidth - 220, 50, 200, 30);
-    player2WeaponLabel->setStyleSheet("color: white; font-size: 16px;");
-    player2WeaponLabel->hide();
-
-    // 创建护甲显示
-    player1ArmorLabel = new QLabel(this);
-    player1ArmorLabel->setGeometry(20, 80, 200, 30);
-    player1ArmorLabel->setStyleSheet("color: white; font-size: 16px;");
-    player1ArmorLabel->hide();
-
-    player2ArmorLabel = new QLabel(this);
-    player2ArmorLabel->setGeometry(gameWidth - 220, 80, 200, 30);
-    player2ArmorLabel->setStyleSheet("color: white; font-size: 16px;");
-    player2ArmorLabel->hide();
-
     // 创建游戏结束标签
     gameOverLabel = new QLabel(this);
     gameOverLabel->setGeometry(gameWidth / 2 - 200, gameHeight / 2 - 50, 400, 100);
@@ -158,97 +171,60 @@ void GameWindow::startGame()
     // 设置游戏模式为PVP
     gameMode = GameMode::PLAYER_VS_PLAYER;
 
-    // 重置游戏状态
-    scene->clear();
-    platforms.clear();
-    items.clear();
-    projectiles.clear();
-
-    QPixmap backgroundPixmap("./images/vs.jpeg");
-    if (!backgroundPixmap.isNull())
-    {
-        // 缩放图片以适应场景大小
-        QPixmap scaledBackground = backgroundPixmap.scaled(gameWidth, gameHeight, Qt::KeepAspectRatioByExpanding, Qt::SmoothTransformation);
+    // 每局使用新的随机种子，物品生成和AI决策都由它决定
+    beginMatch(QRandomGenerator::global()->generate(), false);
+}
 
-        // 创建背景图片项并添加到场景
-        QGraphicsPixmapItem *backgroundItem = new QGraphicsPixmapItem(scaledBackground);
-        backgroundItem->setPos(0, 0);
-        backgroundItem->setZValue(-1000); // 确保背景在最底层
-        backgroundItem->setOpacity(0.2);  // 设置背景透明度
-        scene->addItem(backgroundItem);
-    }
+void GameWindow::startAIGame()
+{
+    // 设置游戏模式为AI对战
+    gameMode = GameMode::PLAYER_VS_AI;
 
-    // 移除AI
-    if (ai)
-    {
-        delete ai;
-        ai = nullptr;
-    }
+    // 每局使用新的随机种子，物品生成和AI决策都由它决定
+    beginMatch(QRandomGenerator::global()->generate(), false);
+}
 
-    // 重置按键状态
-    for (int i = 0; i < 10; i++)
+bool GameWindow::startReplay(const QString &path)
+{
+    QString error;
+    if (!replay.load(path, &error))
     {
-        keys[i] = false;
+        qWarning() << "无法加载录像" << path << error;
+        return false;
     }
 
-    // 隐藏开始按钮和游戏结束标签
-    startButton->hide();
-    aiButton->hide();
-    gameOverLabel->hide();
-
-    // 显示游戏信息
-    player1HealthLabel->show();
-    player2HealthLabel->show();
-    player1WeaponLabel->show();
-    player2WeaponLabel->show();
-    player1ArmorLabel->show();
-    player2ArmorLabel->show();
-
-    // 设置玩家2标签
-    player2HealthLabel->setText("安室透生命值: 100");
-    player2WeaponLabel->setText("武器: 拳头(近战)");
-    player2ArmorLabel->setText("护甲: 无");
-
-    // 创建游戏元素
-    createPlayers();
-    createPlatforms();
-
-    // 确保视图有焦点
-    view->setFocus();
-
-    // 启动游戏定时器
-    gameRunning = true;
-    gameTimer->start(16);   // 约60FPS
-    itemTimer->start(5000); // 每5秒生成一个物品
+    // 使用录像中的帧率、模式和种子，逐帧输入录像中的按键和AI决定
+    // 帧率只在这次回放中使用，之后的对局恢复用户设置的帧率
+    applyTickRate(replay.getTickRate());
+    gameMode = replay.getGameMode();
+    beginMatch(replay.getSeed(), true);
+    return true;
 }
 
-void GameWindow::startAIGame()
+void GameWindow::setRecordPath(const QString &path)
 {
-    // 设置游戏模式为AI对战
-    gameMode = GameMode::PLAYER_VS_AI;
-
-    // 重置游戏状态
-    scene->clear();
-    platforms.clear();
-    items.clear();
-    projectiles.clear();
+    recordPath = path;
+}
 
-    QPixmap backgroundPixmap("./images/vs.jpeg");
-    if (!backgroundPixmap.isNull())
+void GameWindow::beginMatch(quint32 seed, bool replayMatch)
+{
+    // 回放可能改过帧率，正常对局恢复用户设置的帧率
+    if (!replayMatch)
     {
-        // 缩放图片以适应场景大小
-        QPixmap scaledBackground = backgroundPixmap.scaled(gameWidth, gameHeight, Qt::KeepAspectRatioByExpanding, Qt::SmoothTransformation);
+        applyTickRate(tickRate);
+    }
 
-        // 创建背景图片项并添加到场景
-        QGraphicsPixmapItem *backgroundItem = new QGraphicsPixmapItem(scaledBackground);
-        backgroundItem->setPos(0, 0);
-        backgroundItem->setZValue(-1000); // 确保背景在最底层
-        backgroundItem->setOpacity(0.2);  // 设置背景透明度
-        scene->addItem(backgroundItem);
+    // 重置游戏状态（静态层在setupScene中创建，会一直保留在场景里）
+    world->reset(gameMode, seed);
+    world->setReplayMode(replayMatch);
+    replaying = replayMatch;
+    if (!replaying)
+    {
+        recording.begin(seed, world->getTickRate(), gameMode);
     }
 
     // 重置按键状态
-    for (int i = 0; i < 10; i++)
+    for (int i = 0; i < SIM_KEY_COUNT; i++)
     {
         keys[i] = false;
     }
@@ -258,153 +234,133 @@ void GameWindow::startAIGame()
     aiButton->hide();
     gameOverLabel->hide();
 
-    // 显示游戏信息
-    player1HealthLabel->show();
-    player2HealthLabel->show();
-    player1WeaponLabel->show();
-    player2WeaponLabel->show();
-    player1ArmorLabel->show();
-    player2ArmorLabel->show();
-
-    // 设置AI标签
-    player2HealthLabel->setText("AI生命值: 100");
-    player2WeaponLabel->setText("武器: 拳头(近战)");
-    player2ArmorLabel->setText("护甲: 无");
-
-    // 创建游戏元素
-    createPlayers();
-    createPlatforms();
+    // 显示游戏信息，玩家2的名字取决于模式
+    if (gameMode == GameMode::PLAYER_VS_PLAYER)
+    {
+        hud->setPlayerNames("赤井秀一", "安室透");
+    }
+    else
+    {
+        hud->setPlayerNames("赤井秀一", "AI");
+    }
+    hud->show();
 
-    // 创建AI控制器
-    ai = new AI(player2);
+    // 把游戏元素加入场景（AI控制器由游戏世界创建）
+    addWorldToScene();
 
     // 确保视图有焦点
-    view->setFocus();
+    renderWidget()->setFocus();
 
     // 启动游戏定时器
     gameRunning = true;
-    gameTimer->start(16);   // 约60FPS
-    itemTimer->start(5000); // 每5秒生成一个物品
+    stepLoop.start();
+    gameTimer->start(16);   // 约60FPS渲染，逻辑帧率由stepLoop决定
 }
 
-void GameWindow::createPlayers()
+void GameWindow::addWorldToScene()
 {
-    // 创建玩家1 - 初始位置改为平台上方
-    player1 = new Player(250, gameHeight - 260, QColor(0, 0, 255), 1); // 放在左侧草地平台上
-    scene->addItem(player1);
-
-    // 创建玩家2 - 初始位置改为平台上方
-    player2 = new Player(850, gameHeight - 260, QColor(255, 0, 0), 2); // 放在右侧冰面平台上
-    scene->addItem(player2);
-
-    // 初始化UI显示
-    player1WeaponLabel->setText("武器: 拳头(近战)");
-    player1ArmorLabel->setText("护甲: 无");
-    player1HealthLabel->setText("赤井秀一生命值: 100");
+    // 平台不加入场景，关卡变化时才重新合成到静态层中
+    staticLayer->rebuild(world->getRegistry().table(EntityKind::PLATFORM));
+
+    // 添加玩家的渲染代理
+
+    PlayerSprite *player1 = world->getPlayerSprite(world->getPlayer1());
+    PlayerSprite *player2 = world->getPlayerSprite(world->getPlayer2());
+    if (renderBackend == RenderBackend::SCENE)
+    {
+        scene->addItem(player1);
+        scene->addItem(player2);
+    }
+
+    // 初始化信息栏
+    hud->refresh(world->getPlayer1(), world->getPlayer2());
     // 设置玩家图片
     player2->setPlayerImage("./images/anshi.jpeg");
     player1->setPlayerImage("./images/chijing.jpeg");
 }
 
-void GameWindow::createPlatforms()
+void GameWindow::addItemToScene(Item *item)
 {
-    // 创建地面
-    Platform *ground = new Platform(0, gameHeight - 50, gameWidth, 50, PlatformType::GROUND);
-    platforms.append(ground);
-    scene->addItem(ground);
-
-    // 创建草地平台（二层平台）
-    Platform *grassPlatform = new Platform(200, gameHeight - 200, 300, 30, PlatformType::GRASS);
-    platforms.append(grassPlatform);
-    scene->addItem(grassPlatform);
-
-    // 创建冰面平台（二层平台）
-    Platform *icePlatform = new Platform(700, gameHeight - 200, 300, 30, PlatformType::ICE);
-    platforms.append(icePlatform);
-    scene->addItem(icePlatform);
-
-    // 创建高层平台（三层平台）
-    Platform *highPlatform1 = new Platform(150, gameHeight - 350, 200, 30, PlatformType::GROUND);
-    platforms.append(highPlatform1);
-    scene->addItem(highPlatform1);
-
-    Platform *highPlatform2 = new Platform(850, gameHeight - 350, 200, 30, PlatformType::GROUND);
-    platforms.append(highPlatform2);
-    scene->addItem(highPlatform2);
-
-    // 创建中间平台（三层平台）
-    Platform *middlePlatform = new Platform(gameWidth / 2 - 150, gameHeight - 500, 300, 30, PlatformType::GROUND);
-    platforms.append(middlePlatform);
-    scene->addItem(middlePlatform);
+    // 批量渲染时实体不进入场景，直接从注册表绘制
+    if (renderBackend == RenderBackend::SCENE)
+        scene->addItem(item);
 }
 
-void GameWindow::spawnItem()
+void GameWindow::addProjectileToScene(Projectile *projectile)
 {
-    // 随机生成物品类型
-    int itemTypeRand = QRandomGenerator::global()->bounded(100);
-    ItemType type;
-
-    if (itemTypeRand < 10)
-    {
-        type = ItemType::KNIFE;
-    }
-    else if (itemTypeRand < 20)
-    {
-        type = ItemType::BALL;
-    }
-    else if (itemTypeRand < 30)
+    // 对象池复用的投射物已经在场景中，只是被隐藏了
+    if (renderBackend == RenderBackend::SCENE && projectile->scene() != scene)
     {
-        type = ItemType::RIFLE;
+        scene->addItem(projectile);
     }
-    else if (itemTypeRand < 40)
-    {
-        type = ItemType::SNIPER;
-    }
-    else if (itemTypeRand < 55)
-    {
-        type = ItemType::BANDAGE;
-    }
-    else if (itemTypeRand < 65)
-    {
-        type = ItemType::MEDKIT;
-    }
-    else if (itemTypeRand < 75)
-    {
-        type = ItemType::ADRENALINE;
-    }
-    else if (itemTypeRand < 87)
-    {
-        type = ItemType::LIGHT_ARMOR;
-    }
-    else
-    {
-        type = ItemType::BULLETPROOF_VEST;
-    }
-
-    // 在随机位置生成物品
-    int x = QRandomGenerator::global()->bounded(100, gameWidth - 100);
-    Item *item = new Item(x, 0, type);
-    items.append(item);
-    scene->addItem(item);
 }
 
-void GameWindow::spawnItems()
+void GameWindow::setRenderBackend(RenderBackend backend)
 {
-    if (!gameRunning)
+    if (backend == renderBackend)
         return;
-    spawnItem();
+    renderBackend = backend;
+
+    // 批量渲染时把玩家、物品和投射物移出场景，场景不再为它们维护索引
+    clearInterpolation();
+    setProxiesInScene(backend == RenderBackend::SCENE);
+
+    renderStack->setCurrentWidget(renderWidget());
+    renderWidget()->setFocus();
+}
 
-    // 限制物品数量，防止过多
-    if (items.size() > 15)
+void GameWindow::setProxiesInScene(bool inScene)
+{
+    const EntityRegistry &registry = world->getRegistry();
+    EntityKind kinds[3] = {EntityKind::PLAYER, EntityKind::ITEM, EntityKind::PROJECTILE};
+    for (EntityKind kind : kinds)
     {
-        scene->removeItem(items.first());
-        delete items.first();
-        items.removeFirst();
+        const EntityTable &table = registry.table(kind);
+        for (int i = 0; i < table.size(); i++)
+        {
+            QGraphicsItem *proxy = table.proxy[i];
+            if (!proxy)
+                continue;
+            if (inScene && proxy->scene() != scene)
+                scene->addItem(proxy);
+            else if (!inScene && proxy->scene() == scene)
+                scene->removeItem(proxy);
+        }
     }
 }
 
+QWidget *GameWindow::renderWidget() const
+{
+    if (renderBackend == RenderBackend::BATCHED)
+        return renderer;
+    return view;
+}
+
 void GameWindow::keyPressEvent(QKeyEvent *event)
 {
+    // F3切换渲染方式，便于对比两种方式的开销
+    if (event->key() == Qt::Key_F3 && !event->isAutoRepeat())
+    {
+        setRenderBackend(renderBackend == RenderBackend::SCENE ? RenderBackend::BATCHED : RenderBackend::SCENE);
+        event->accept();
+        return;
+    }
+
+    // F4显示或隐藏帧分析叠加层，F5把最近的帧导出为Chrome trace
+    if (event->key() == Qt::Key_F4 && !event->isAutoRepeat())
+    {
+        profiler.setOverlayVisible(!profiler.isOverlayVisible());
+        renderWidget()->update();
+        event->accept();
+        return;
+    }
+    if (event->key() == Qt::Key_F5 && !event->isAutoRepeat())
+    {
+        exportTrace();
+        event->accept();
+        return;
+    }
+
     if (!gameRunning)
     {
         QMainWindow::keyPressEvent(event);
@@ -453,16 +409,11 @@ void GameWindow::keyReleaseEvent(QKeyEvent *event)
     }
 
     // 玩家1控制
+    // 松开左右键时的停止移动由游戏世界在下一帧处理
     if (event->key() == Qt::Key_A)
-    {
         keys[0] = false;
-        player1->stopMoving();
-    }
     if (event->key() == Qt::Key_D)
-    {
         keys[1] = false;
-        player1->stopMoving();
-    }
     if (event->key() == Qt::Key_W)
         keys[2] = false;
     if (event->key() == Qt::Key_S)
@@ -474,15 +425,9 @@ void GameWindow::keyReleaseEvent(QKeyEvent *event)
     if (gameMode == GameMode::PLAYER_VS_PLAYER)
     {
         if (event->key() == 0x01000012)
-        { // Qt::Key_Left
-            keys[5] = false;
-            player2->stopMoving();
-        }
+            keys[5] = false; // Qt::Key_Left
         if (event->key() == 0x01000014)
-        { // Qt::Key_Right
-            keys[6] = false;
-            player2->stopMoving();
-        }
+            keys[6] = false; // Qt::Key_Right
         if (event->key() == 0x01000013)
             keys[7] = false; // Qt::Key_Up
         if (event->key() == 0x01000015)
@@ -494,224 +439,190 @@ void GameWindow::keyReleaseEvent(QKeyEvent *event)
     event->accept();
 }
 
+void GameWindow::setTickRate(int hz)
+{
+    tickRate = roundTickRate(hz);
+    applyTickRate(tickRate);
+}
+
+void GameWindow::applyTickRate(int hz)
+{
+    world->setTickRate(hz);
+    stepLoop.setTickRate(world->getTickRate());
+}
+
 void GameWindow::updateGame()
 {
     if (!gameRunning)
         return;
 
-    // 更新玩家1状态
-    if (keys[0])
-        player1->moveLeft();
-    if (keys[1])
-        player1->moveRight();
-    if (keys[2])
-        player1->jump();
-    if (keys[3])
-        player1->crouch(true);
-    else
-        player1->crouch(false);
-    if (keys[4])
-        player1->fire(projectiles, scene);
+    // 上一帧（包括它的绘制）到此结束
+    profiler.nextFrame();
 
-    // 更新玩家2状态 - PVP模式
-    if (gameMode == GameMode::PLAYER_VS_PLAYER)
-    {
-        if (keys[5])
-            player2->moveLeft();
-        if (keys[6])
-            player2->moveRight();
-        if (keys[7])
-            player2->jump();
-        if (keys[8])
-            player2->crouch(true);
-        else
-            player2->crouch(false);
-        if (keys[9])
-            player2->fire(projectiles, scene);
-    }
-    // AI模式 - 更新AI
-    else if (gameMode == GameMode::PLAYER_VS_AI && ai)
+    // 按真实经过的时间推进若干个逻辑帧，定时器抖动不会让游戏变慢
+    int steps = stepLoop.advance();
+    if (steps > 0)
     {
-        ai->update(player1, items, platforms, projectiles, scene);
-    }
-
-    // 应用重力和移动
-    player1->applyGravity();
-    player2->applyGravity();
+        // 碰撞检测依赖真实坐标，推进前先去掉插值偏移
+        clearInterpolation();
+        qint64 simulationStart = profiler.now();
+        for (int i = 0; i < steps && gameRunning; i++)
+        {
+            TickInput input;
+            if (replaying)
+            {
+                // 录像放完但没有分出胜负（例如录制时超时），直接结束
+                if (!replay.next(input))
+                {
+                    gameOver(0);
+                    break;
+                }
+            }
+            else
+            {
+                input.player[0] = inputFromKeys(keys);
+                input.player[1] = inputFromKeys(keys + 5);
+            }
 
-    player1->move();
-    player2->move();
+            world->step(input);
 
-    player1->updateEffects();
-    player2->updateEffects();
+            if (!replaying)
+            {
+                recording.record(*world);
+            }
+        }
 
-    // 在检查碰撞前重置地面状态
-    player1->setOnGround(false);
-    player2->setOnGround(false);
+        // 对局在这次推进中结束：最后一帧的输入已经录入，这时才保存录像
+        if (!replaying && !world->isRunning())
+        {
+            saveRecording();
+        }
 
-    // 保存上一帧位置，用于碰撞检测
-    QPointF player1Pos = player1->pos();
-    QPointF player2Pos = player2->pos();
+        profiler.addSimulation(*world, simulationStart, steps);
 
-    // 检查玩家与平台的碰撞
-    for (Platform *platform : platforms)
-    {
-        player1->checkPlatformCollision(platform);
-        player2->checkPlatformCollision(platform);
-        // 更新物品与平台的碰撞
-        for (Item *item : items)
+        // 渲染代理的位置只在绘制前同步一次，而不是每个逻辑帧
         {
-            item->applyGravity();
-            item->move();
-            item->checkPlatformCollision(platform);
+            ProfileScope scope(profiler, PROFILE_SYNC);
+            world->syncRenderProxies();
         }
-    }
 
-    // 更新投射物
-    for (int i = 0; i < projectiles.size(); i++)
-    {
-        projectiles[i]->move();
-
-        // 检查投射物边界
-        if (projectiles[i]->x() < 0 || projectiles[i]->x() > gameWidth ||
-            projectiles[i]->y() < 0 || projectiles[i]->y() > gameHeight)
+        // 更新界面信息
         {
-            scene->removeItem(projectiles[i]);
-            delete projectiles[i];
-            projectiles.removeAt(i);
-            i--;
-            continue;
+            ProfileScope scope(profiler, PROFILE_HUD);
+            renderInfo();
         }
     }
+    profiler.setEntityCounts(world->getRegistry());
+    profiler.setLoopState(stepLoop);
 
-    // 检查物品拾取和其他碰撞
-    checkCollisions();
+    // 场景只重绘变化的区域，叠加层需要每帧刷新
+    if (profiler.isOverlayVisible() && renderBackend == RenderBackend::SCENE)
+        view->viewport()->update(FrameProfiler::overlayRect(gameWidth).toRect());
 
-    // 更新玩家状态效果
-    player1->updateEffects();
-    player2->updateEffects();
+    // 在最近两帧之间插值显示
+    if (gameRunning)
+    {
+        if (renderBackend == RenderBackend::BATCHED)
+            renderer->setAlpha(stepLoop.getAlpha());
+        else
+            applyInterpolation(stepLoop.getAlpha());
+    }
+}
 
-    // 更新界面信息
-    renderInfo();
+// 用平移变换把实体显示在插值位置上，不修改实体的真实坐标
+static void interpolateItem(QGraphicsItem *item, const QPointF &previousPos, qreal alpha)
+{
+    QPointF offset = (previousPos - item->pos()) * (1.0 - alpha);
+    item->setTransform(QTransform::fromTranslate(offset.x(), offset.y()));
 }
 
-void GameWindow::checkCollisions()
+void GameWindow::applyInterpolation(qreal alpha)
 {
-    // 检查玩家与物品碰撞（拾取）
-    for (int i = 0; i < items.size(); i++)
+    // 只有玩家和投射物会快速移动，上一帧位置直接从注册表中读取
+    const EntityRegistry &registry = world->getRegistry();
+    EntityKind kinds[2] = {EntityKind::PLAYER, EntityKind::PROJECTILE};
+    for (EntityKind kind : kinds)
     {
-        // 只有在下蹲状态且与物品碰撞时才拾取
-        if (player1->isCrouching() && player1->collidesWithItem(items[i]))
-        {
-            player1->pickupItem(items[i]);
-            scene->removeItem(items[i]);
-            delete items[i];
-            items.removeAt(i);
-            i--;
-            continue;
-        }
-
-        if (player2->isCrouching() && player2->collidesWithItem(items[i]))
+        const EntityTable &table = registry.table(kind);
+        for (int i = 0; i < table.size(); i++)
         {
-            player2->pickupItem(items[i]);
-            scene->removeItem(items[i]);
-            delete items[i];
-            items.removeAt(i);
-            i--;
-            continue;
+            if (table.proxy[i])
+                interpolateItem(table.proxy[i], table.previousPosition(i), alpha);
         }
     }
+}
 
-    // 检查投射物与玩家碰撞
-    for (int i = 0; i < projectiles.size(); i++)
+void GameWindow::clearInterpolation()
+{
+    const EntityRegistry &registry = world->getRegistry();
+    EntityKind kinds[2] = {EntityKind::PLAYER, EntityKind::PROJECTILE};
+    for (EntityKind kind : kinds)
     {
-        // 检查是否击中玩家1（排除自己发射的投射物）
-        if (projectiles[i]->getOwnerID() != 1 && player1->collidesWithItem(projectiles[i]))
+        const EntityTable &table = registry.table(kind);
+        for (int i = 0; i < table.size(); i++)
         {
-            player1->takeDamage(projectiles[i]->getDamage(), projectiles[i]->getType());
-            scene->removeItem(projectiles[i]);
-            delete projectiles[i];
-            projectiles.removeAt(i);
-            i--;
-
-            // 检查玩家1是否已死亡
-            if (player1->getHealth() <= 0)
-            {
-                gameOver(player2);
-                return;
-            }
-            continue;
-        }
-
-        // 检查是否击中玩家2（排除自己发射的投射物）
-        if (projectiles[i]->getOwnerID() != 2 && player2->collidesWithItem(projectiles[i]))
-        {
-            player2->takeDamage(projectiles[i]->getDamage(), projectiles[i]->getType());
-            scene->removeItem(projectiles[i]);
-            delete projectiles[i];
-            projectiles.removeAt(i);
-            i--;
-
-            // 检查玩家2是否已死亡
-            if (player2->getHealth() <= 0)
-            {
-                gameOver(player1);
-                return;
-            }
-            continue;
-        }
-
-        // 检查投射物与平台的碰撞
-        for (Platform *platform : platforms)
-        {
-            if (i < projectiles.size() && projectiles[i] && projectiles[i]->collidesWithItem(platform))
-            {
-                // 只有子弹和球才会与平台碰撞消失
-                if (projectiles[i]->getType() != ProjectileType::MELEE)
-                {
-                    scene->removeItem(projectiles[i]);
-                    delete projectiles[i];
-                    projectiles.removeAt(i);
-                    i--;
-                    break;
-                }
-            }
+            if (table.proxy[i])
+                table.proxy[i]->resetTransform();
         }
     }
 }
 
-void GameWindow::renderInfo()
+void GameWindow::exportTrace()
 {
-    // 更新生命值显示
-    player1HealthLabel->setText(QString("赤井秀一生命值: %1").arg(player1->getHealth()));
-
-    if (gameMode == GameMode::PLAYER_VS_PLAYER)
+    QString path = QString("trace-%1.json").arg(QDateTime::currentDateTime().toString("yyyyMMdd-hhmmss"));
+    QString error;
+    if (profiler.exportChromeTrace(path, &error))
     {
-        player2HealthLabel->setText(QString("安室透生命值: %1").arg(player2->getHealth()));
+        qDebug() << "帧分析已导出到" << path;
     }
     else
     {
-        player2HealthLabel->setText(QString("AI生命值: %1").arg(player2->getHealth()));
+        qWarning() << "无法导出帧分析" << path << error;
     }
+}
 
-    // 更新武器显示
-    player1WeaponLabel->setText(QString("武器: %1").arg(player1->getWeaponName()));
-    player2WeaponLabel->setText(QString("武器: %1").arg(player2->getWeaponName()));
+void GameWindow::saveRecording()
+{
+    if (recordPath.isEmpty())
+        return;
 
-    // 更新护甲显示
-    player1ArmorLabel->setText(QString("护甲: %1").arg(player1->getArmorName()));
-    player2ArmorLabel->setText(QString("护甲: %1").arg(player2->getArmorName()));
+    QString error;
+    if (!recording.save(recordPath, &error))
+    {
+        qWarning() << "无法保存录像" << recordPath << error;
+    }
 }
 
-void GameWindow::gameOver(Player *winner)
+void GameWindow::renderInfo()
+{
+    // 只有数值变化的行才会重新排版和重绘
+    hud->refresh(world->getPlayer1(), world->getPlayer2());
+}
+
+void GameWindow::gameOver(int winnerID)
 {
     gameRunning = false;
     gameTimer->stop();
-    itemTimer->stop();
+    clearInterpolation();
+
+    quint32 checksum = world->stateChecksum();
+    if (replaying)
+    {
+        // 校验回放结果是否与录制时一致
+        if (winnerID != replay.getWinnerID() || checksum != replay.getChecksum())
+        {
+            qWarning() << "回放结果与录像不一致";
+        }
+    }
+    // 录制中的对局在updateGame()录入最后一帧之后才保存
 
     // 显示游戏结束信息
     gameOverLabel->setGeometry(gameWidth / 2 - 200, gameHeight / 2 - 150, 400, 100);
-    if (winner->getPlayerID() == 1)
+    if (winnerID == 0)
+    {
+        gameOverLabel->setText("回放结束");
+    }
+    else if (winnerID == 1)
     {
         gameOverLabel->setText("游戏结束！\n赤井秀一胜利！");
     }
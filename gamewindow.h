@@ -8,22 +8,17 @@
 #include <QKeyEvent>
 #include <QLabel>
 #include <QPushButton>
+#include <QStackedWidget>
 #include <QPixmap>
 #include <QRandomGenerator>
-#include "player.h"
-#include "platform.h"
-#include "item.h"
-#include "projectile.h"
-
-// 前置声明，避免头文件引用警告
-class Weapon;
-class AI;
-
-// 游戏模式枚举
-enum class GameMode {
-    PLAYER_VS_PLAYER,
-    PLAYER_VS_AI
-};
+#include "simworld.h"
+#include "staticlayer.h"
+#include "worldrenderer.h"
+#include "hud.h"
+#include "gameview.h"
+#include "frameprofiler.h"
+#include "fixedsteploop.h"
+#include "replay.h"
 
 class GameWindow : public QMainWindow
 {
@@ -33,6 +28,18 @@ public:
     GameWindow(QWidget *parent = nullptr);
     ~GameWindow();
 
+    // 设置逻辑帧率（60/120/240），与渲染帧率无关
+    void setTickRate(int hz);
+
+    // 每局结束后把录像保存到path（为空则不录像）
+    void setRecordPath(const QString &path);
+
+    // 加载并回放录像，逐帧把录像中的输入送入游戏循环
+    bool startReplay(const QString &path);
+
+    // 选择渲染方式，游戏中也可以按F3切换
+    void setRenderBackend(RenderBackend backend);
+
 protected:
     void keyPressEvent(QKeyEvent *event) override;
     void keyReleaseEvent(QKeyEvent *event) override;
@@ -40,40 +47,47 @@ protected:
 
 private slots:
     void updateGame();
-    void spawnItems();
     void startGame();
     void startAIGame();  // 新增 - 开始AI对战
-    void gameOver(Player* winner);
+    void gameOver(int winnerID);
+    void addItemToScene(Item *item);
+    void addProjectileToScene(Projectile *projectile);
 
 private:
+    void preloadAssets();
     void setupScene();
-    void createPlayers();
-    void createPlatforms();
     void createControls();
-    void spawnItem();
-    void checkCollisions();
+    void beginMatch(quint32 seed, bool replayMatch);
+    void applyTickRate(int hz);
+    void addWorldToScene();
+    void setProxiesInScene(bool inScene);
+    QWidget *renderWidget() const;
     void renderInfo();
+    void applyInterpolation(qreal alpha);
+    void clearInterpolation();
+    void exportTrace();
+    void saveRecording();
 
     QGraphicsScene *scene;
-    QGraphicsView *view;
+    GameView *view;
+    StaticLayer *staticLayer;   // 背景和平台合成的静态层
+    WorldRenderer *renderer;    // 批量渲染器，与view二选一显示
+    QStackedWidget *renderStack;
+    RenderBackend renderBackend;
     QTimer *gameTimer;
-    QTimer *itemTimer;
-    QLabel *player1HealthLabel;
-    QLabel *player2HealthLabel;
-    QLabel *player1WeaponLabel;
-    QLabel *player2WeaponLabel;
-    QLabel *player1ArmorLabel;  // 新增 - 护甲显示
-    QLabel *player2ArmorLabel;  // 新增 - 护甲显示
+    Hud *hud;                   // 双方的生命值、武器和护甲
     QLabel *gameOverLabel;
     QPushButton *startButton;
     QPushButton *aiButton;      // 新增 - AI对战按钮
 
-    Player *player1;
-    Player *player2;
-    AI *ai;                     // 新增 - AI控制器
-    QList<Platform*> platforms;
-    QList<Item*> items;
-    QList<Projectile*> projectiles;
+    SimWorld *world;            // 游戏逻辑，窗口只负责显示和输入
+    FixedStepLoop stepLoop;     // 固定步长循环，gameTimer只负责驱动渲染
+    FrameProfiler profiler;     // 每帧各阶段的耗时，F4显示叠加层，F5导出
+    Replay recording;           // 当前对局的录像
+    Replay replay;              // 正在回放的录像
+    QString recordPath;
+    bool replaying;
+    int tickRate;               // 用户设置的逻辑帧率，回放时临时改用录像的帧率
 
     int gameWidth;
     int gameHeight;
@@ -81,7 +95,7 @@ private:
     GameMode gameMode;          // 新增 - 游戏模式
 
     // 用于记录按键状态
-    bool keys[10] = {false};
+    bool keys[SIM_KEY_COUNT] = {false};
 
     // 键盘映射
     const Qt::Key player1Keys[5] = {Qt::Key_A, Qt::Key_D, Qt::Key_W, Qt::Key_S, Qt::Key_Space};
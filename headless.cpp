@@ -0,0 +1,190 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <QDir>
+#include <QTemporaryDir>
+#include <QRandomGenerator>
+#include "simworld.h"
+#include "replay.h"
+
+// 回放录像并校验结果，与录制时不一致返回false
+static bool verifyReplay(const QString &path, QTextStream &out)
+{
+    Replay replay;
+    QString error;
+    if (!replay.load(path, &error))
+    {
+        out << QString("无法加载录像%1: %2\n").arg(path, error);
+        return false;
+    }
+
+    SimWorld world;
+    world.setTickRate(replay.getTickRate());
+    world.reset(replay.getGameMode(), replay.getSeed());
+    world.setReplayMode(true);
+
+    TickInput input;
+    qint64 tick = 0;
+    while (world.isRunning() && replay.next(input))
+    {
+        world.step(input);
+        tick++;
+    }
+
+    bool ok = world.getWinnerID() == replay.getWinnerID()
+              && tick == replay.getTickCount()
+              && world.stateChecksum() == replay.getChecksum();
+    out << QString("回放%1: 胜者=%2 帧数=%3 校验和=%4 %5\n")
+               .arg(path).arg(world.getWinnerID()).arg(tick)
+               .arg(world.stateChecksum(), 8, 16, QChar('0'))
+               .arg(ok ? "一致" : "不一致");
+    return ok;
+}
+
+// 录制→回放自检：与GameWindow::updateGame()相同，每次step()之后用Replay::record()录入，
+// 对局结束后才保存；玩家1由伪随机按键控制（每隔几帧换一组按键），玩家2由AI控制
+// 保存后再回放，胜者、帧数和校验值必须与录制时一致
+static bool roundTrip(quint32 seed, int tickRate, int maxSeconds, const QString &dir, QTextStream &out)
+{
+    SimWorld world;
+    world.setTickRate(tickRate);
+    int maxTicks = maxSeconds * world.getTickRate();
+    world.reset(GameMode::PLAYER_VS_AI, seed);
+
+    Replay recording;
+    recording.begin(seed, world.getTickRate(), GameMode::PLAYER_VS_AI);
+
+    QRandomGenerator keys(seed);
+    TickInput input;
+    int tick = 0;
+    while (world.isRunning() && tick < maxTicks)
+    {
+        if (tick % 12 == 0)
+            input.player[0] = quint8(keys.bounded(32));    // 左、右、跳、蹲、攻击的任意组合
+        world.step(input);
+        recording.record(world);
+        tick++;
+    }
+    if (world.isRunning())
+        recording.setResult(0, world.stateChecksum());     // 超时判为平局
+
+    QString path = QDir(dir).filePath(QString("roundtrip_%1.rpl").arg(seed));
+    QString error;
+    if (!recording.save(path, &error))
+    {
+        out << QString("无法保存录像%1: %2\n").arg(path, error);
+        return false;
+    }
+    return verifyReplay(path, out);
+}
+
+// 无界面模式：在没有显示器的机器上跑AI互搏，不创建任何窗口或场景
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+    QCoreApplication::setApplicationName("HW1_1_headless");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("无界面AI对战模拟");
+    parser.addHelpOption();
+    QCommandLineOption matchesOption("matches", "连续进行的对战场数", "n", "1");
+    QCommandLineOption maxSecondsOption("max-seconds", "单场最长游戏时间（秒），超过判为平局", "seconds", "600");
+    QCommandLineOption tickRateOption("tick-rate", "逻辑帧率（60/120/240）", "hz", "60");
+    QCommandLineOption seedOption("seed", "第一场的随机种子，第n场使用seed+n", "seed", "1");
+    QCommandLineOption recordDirOption("record-dir", "把每场录像保存到该目录（match_<种子>.rpl）", "dir");
+    QCommandLineOption replayOption("replay", "回放录像并校验结果，不一致时返回1", "file");
+    QCommandLineOption roundTripOption("roundtrip", "录制n场人机对战后逐一回放校验，有不一致时返回1", "n");
+    parser.addOption(seedOption);
+    parser.addOption(matchesOption);
+    parser.addOption(maxSecondsOption);
+    parser.addOption(tickRateOption);
+    parser.addOption(recordDirOption);
+    parser.addOption(replayOption);
+    parser.addOption(roundTripOption);
+    parser.process(a);
+
+    QTextStream out(stdout);
+    if (parser.isSet(replayOption))
+    {
+        bool ok = verifyReplay(parser.value(replayOption), out);
+        out.flush();
+        return ok ? 0 : 1;
+    }
+
+    if (parser.isSet(roundTripOption))
+    {
+        QTemporaryDir dir;
+        int rounds = qMax(1, parser.value(roundTripOption).toInt());
+        int tickRate = parser.value(tickRateOption).toInt();
+        int maxSeconds = qMax(1, parser.value(maxSecondsOption).toInt());
+        quint32 firstSeed = parser.value(seedOption).toUInt();
+        int failures = 0;
+        for (int i = 0; i < rounds; i++)
+        {
+            if (!roundTrip(firstSeed + i, tickRate, maxSeconds, dir.path(), out))
+                failures++;
+        }
+        out.flush();
+        return failures > 0 ? 1 : 0;
+    }
+
+    QString recordDir = parser.value(recordDirOption);
+    if (!recordDir.isEmpty())
+    {
+        QDir().mkpath(recordDir);
+    }
+
+    SimWorld world;
+    world.setTickRate(parser.value(tickRateOption).toInt());
+
+    int matches = qMax(1, parser.value(matchesOption).toInt());
+    int maxTicks = qMax(1, parser.value(maxSecondsOption).toInt()) * world.getTickRate();
+    quint32 seed = parser.value(seedOption).toUInt();
+
+    Replay recording;
+    int wins[3] = {0, 0, 0}; // 平局、玩家1、玩家2
+    qint64 totalTicks = 0;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    for (int match = 0; match < matches; match++)
+    {
+        world.reset(GameMode::AI_VS_AI, seed + match);
+        recording.begin(seed + match, world.getTickRate(), GameMode::AI_VS_AI);
+
+        int tick = 0;
+        while (world.isRunning() && tick < maxTicks)
+        {
+            world.step();
+            recording.append(world.getLastInput());
+            tick++;
+        }
+
+        if (!recordDir.isEmpty())
+        {
+            QString path = QDir(recordDir).filePath(QString("match_%1.rpl").arg(seed + match));
+            QString error;
+            recording.setResult(world.getWinnerID(), world.stateChecksum());
+            if (!recording.save(path, &error))
+            {
+                out << QString("无法保存录像%1: %2\n").arg(path, error);
+            }
+        }
+
+        wins[world.getWinnerID()]++;
+        totalTicks += tick;
+        out << QString("第%1场: 种子=%2 胜者=%3 帧数=%4\n")
+                   .arg(match + 1).arg(seed + match).arg(world.getWinnerID()).arg(tick);
+    }
+
+    qint64 elapsed = qMax<qint64>(1, timer.elapsed());
+    out << QString("共%1场，玩家1胜%2，玩家2胜%3，平局%4\n")
+               .arg(matches).arg(wins[1]).arg(wins[2]).arg(wins[0]);
+    out << QString("总帧数%1，用时%2毫秒，%3帧/秒\n")
+               .arg(totalTicks).arg(elapsed).arg(totalTicks * 1000 / elapsed);
+    out.flush();
+
+    return 0;
+}
@@ -0,0 +1,117 @@
+#include "hud.h"
+#include <QPainter>
+
+// 每行文字的区域，与原来的标签位置相同：左上角和右上角各一列，每行高30像素
+static const int HUD_LINE_WIDTH = 200;
+static const int HUD_LINE_HEIGHT = 30;
+static const int HUD_MARGIN = 20;
+
+Hud::Hud(int sceneWidth)
+    : sceneWidth(sceneWidth), valid(false)
+{
+    fonts[HEALTH].setPixelSize(18);
+    fonts[WEAPON].setPixelSize(16);
+    fonts[ARMOR].setPixelSize(16);
+}
+
+void Hud::setPlayerNames(const QString &player1, const QString &player2)
+{
+    names[0] = player1;
+    names[1] = player2;
+    valid = false;
+}
+
+bool Hud::refresh(const Player *player1, const Player *player2)
+{
+    bool changed = refreshPlayer(0, player1);
+    changed = refreshPlayer(1, player2) || changed;
+    valid = true;
+    return changed;
+}
+
+bool Hud::refreshPlayer(int index, const Player *player)
+{
+    Shown &last = shown[index];
+    const Weapon &weapon = player->getWeapon();
+    const Armor &armor = player->getArmor();
+    bool changed = false;
+
+    if (!valid || last.health != player->getHealth())
+    {
+        last.health = player->getHealth();
+        setLine(index, HEALTH, QString("%1生命值: %2").arg(names[index]).arg(last.health));
+        changed = true;
+    }
+
+    if (!valid || last.weapon != weapon.getType() || last.ammo != weapon.getAmmo())
+    {
+        last.weapon = weapon.getType();
+        last.ammo = weapon.getAmmo();
+        QString name = player->getWeaponName();
+        // 弹药无限的武器不显示数量
+        if (last.ammo >= 0)
+            name = QString("%1 (%2)").arg(name).arg(last.ammo);
+        setLine(index, WEAPON, QString("武器: %1").arg(name));
+        changed = true;
+    }
+
+    if (!valid || last.armor != armor.getType() || last.durability != armor.getDurability())
+    {
+        last.armor = armor.getType();
+        last.durability = armor.getDurability();
+        setLine(index, ARMOR, QString("护甲: %1").arg(player->getArmorName()));
+        changed = true;
+    }
+
+    return changed;
+}
+
+void Hud::setLine(int index, Line line, const QString &value)
+{
+    // 排版在这里一次完成，之后每次绘制都直接使用排好的字形
+    QStaticText &staticText = text[index][line];
+    staticText.setText(value);
+    staticText.setPerformanceHint(QStaticText::AggressiveCaching);
+    staticText.prepare(QTransform(), fonts[line]);
+
+    // 只重绘这一行
+    update(lineRect(index, line));
+}
+
+QRectF Hud::lineRect(int index, Line line) const
+{
+    qreal x = index == 0 ? HUD_MARGIN : sceneWidth - HUD_MARGIN - HUD_LINE_WIDTH;
+    return QRectF(x, HUD_MARGIN + int(line) * HUD_LINE_HEIGHT, HUD_LINE_WIDTH, HUD_LINE_HEIGHT);
+}
+
+void Hud::draw(QPainter *painter) const
+{
+    if (!valid)
+        return;
+
+    painter->setPen(Qt::white);
+    for (int index = 0; index < 2; index++)
+    {
+        for (int line = 0; line < LINE_COUNT; line++)
+        {
+            // 在行内垂直居中，和原来的标签一样
+            const QStaticText &staticText = text[index][line];
+            QRectF area = lineRect(index, Line(line));
+            qreal y = area.top() + (area.height() - staticText.size().height()) / 2;
+            painter->setFont(fonts[line]);
+            painter->drawStaticText(QPointF(area.left(), y), staticText);
+        }
+    }
+}
+
+QRectF Hud::boundingRect() const
+{
+    return QRectF(0, HUD_MARGIN, sceneWidth, LINE_COUNT * HUD_LINE_HEIGHT);
+}
+
+void Hud::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+{
+    Q_UNUSED(option);
+    Q_UNUSED(widget);
+    draw(painter);
+}
@@ -0,0 +1,60 @@
+#ifndef HUD_H
+#define HUD_H
+
+#include <QGraphicsItem>
+#include <QStaticText>
+#include <QFont>
+#include "player.h"
+
+// 屏幕上方的双方信息：生命值、武器（含弹药）和护甲
+// 每帧只比较这几个数值，变化了才重新排版对应的一行文字，文字用预先排版好的QStaticText绘制，
+// 没有变化时不做任何格式化、排版或重绘
+// 在场景中是最上层的场景项；批量渲染时由WorldRenderer直接调用draw()
+class Hud : public QGraphicsItem
+{
+public:
+    explicit Hud(int sceneWidth);
+
+    // 设置双方的名字，所有文字在下次refresh()时重新生成
+    void setPlayerNames(const QString &player1, const QString &player2);
+
+    // 与上次显示的数值比较，只重新排版变化的行，返回是否有变化
+    bool refresh(const Player *player1, const Player *player2);
+
+    // 一次绘制所有文字
+    void draw(QPainter *painter) const;
+
+    QRectF boundingRect() const override;
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
+
+private:
+    enum Line {
+        HEALTH,
+        WEAPON,
+        ARMOR,
+        LINE_COUNT
+    };
+
+    // 上次显示的数值
+    struct Shown
+    {
+        int health = -1;
+        WeaponType weapon = WeaponType::FIST;
+        int ammo = 0;
+        ArmorType armor = ArmorType::NONE;
+        int durability = 0;
+    };
+
+    bool refreshPlayer(int index, const Player *player);
+    void setLine(int index, Line line, const QString &text);
+    QRectF lineRect(int index, Line line) const;
+
+    int sceneWidth;
+    QFont fonts[LINE_COUNT];
+    QString names[2];
+    bool valid;                         // 为false时所有行都要重新生成
+    Shown shown[2];
+    QStaticText text[2][LINE_COUNT];
+};
+
+#endif // HUD_H
@@ -2,88 +2,43 @@
 #include <QPainter>
 #include <QBrush>
 
-Item::Item(qreal x, qreal y, ItemType type)
-    : type(type), yVelocity(0), onGround(false)
+Item::Item(ItemType type)
+    : type(type)
 {
-    setRect(0, 0, 30, 30);
-    setPos(x, y);
+    setRect(0, 0, ITEM_SIZE, ITEM_SIZE);
 }
 
-void Item::applyGravity()
+void Item::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
 {
-    if (!onGround) {
-        yVelocity += GRAVITY;
-    }
+    Q_UNUSED(option);
+    Q_UNUSED(widget);
+
+    const Sprite &current = sprite();
+    painter->drawPixmap(current.offset, current.pixmap);
 }
 
-void Item::move()
+const Sprite &Item::sprite() const
 {
-    setPos(x(), y() + yVelocity);
+    return SpriteCache::instance().get(SpriteKind::ITEM, quint32(type), spriteBounds(),
+                                       [this](QPainter *target) { draw(target); });
 }
 
-void Item::checkPlatformCollision(Platform *platform)
+QRectF Item::boundingRect() const
 {
-    if (collidesWithItem(platform)) {
-        QRectF itemRect = sceneBoundingRect();
-        QRectF platformRect = platform->sceneBoundingRect();
-
-        // 检查是否从上方着陆
-        if (itemRect.bottom() >= platformRect.top() &&
-            itemRect.bottom() - yVelocity <= platformRect.top()) {
-            // 着陆在平台上
-            setY(platformRect.top() - rect().height());
-            yVelocity = 0;
-            onGround = true;
-        }
-    }
+    return QRectF(spriteBounds().toAlignedRect());
 }
 
-void Item::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+QRectF Item::spriteBounds() const
 {
-    Q_UNUSED(option);
-    Q_UNUSED(widget);
-
-    QColor color;
-    QString label;
+    // 边框宽2像素，会超出矩形1像素
+    return rect().adjusted(-1, -1, 1, 1);
+}
 
-    switch (type) {
-    case ItemType::KNIFE:
-        color = QColor(200, 200, 200);
-        label = "小刀";
-        break;
-    case ItemType::BALL:
-        color = QColor(50, 50, 50);
-        label = "实心球";
-        break;
-    case ItemType::RIFLE:
-        color = QColor(100, 100, 100);
-        label = "步枪";
-        break;
-    case ItemType::SNIPER:
-        color = QColor(70, 70, 70);
-        label = "狙击枪";
-        break;
-    case ItemType::BANDAGE:
-        color = QColor(255, 255, 255);
-        label = "绷带+25";
-        break;
-    case ItemType::MEDKIT:
-        color = QColor(255, 0, 0);
-        label = "医疗箱+100";
-        break;
-    case ItemType::ADRENALINE:
-        color = QColor(255, 255, 0);
-        label = "肾上腺素";
-        break;
-    case ItemType::LIGHT_ARMOR:
-        color = QColor(100, 100, 255);
-        label = "轻甲";
-        break;
-    case ItemType::BULLETPROOF_VEST:
-        color = QColor(50, 150, 50);
-        label = "防弹衣";
-        break;
-    }
+void Item::draw(QPainter *painter) const
+{
+    const ItemStats &stats = itemStats(type);
+    QColor color(stats.red, stats.green, stats.blue);
+    QString label = QString::fromUtf8(stats.label);
 
     painter->setBrush(QBrush(color));
     painter->drawRect(rect());
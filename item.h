@@ -3,39 +3,33 @@
 
 #include <QGraphicsRectItem>
 #include <QColor>
-#include "platform.h"
-
-enum class ItemType {
-    KNIFE,
-    BALL,
-    RIFLE,
-    SNIPER,
-    BANDAGE,
-    MEDKIT,
-    ADRENALINE,
-    LIGHT_ARMOR,    // 新增 - 轻甲
-    BULLETPROOF_VEST // 新增 - 防弹衣
-};
+#include "gamedata.h"
+#include "spritecache.h"
+
+// 物品的尺寸和下落的重力加速度（物品下落速度较慢）
+const qreal ITEM_SIZE = 30;
+const qreal ITEM_GRAVITY = 0.2;
 
+// 物品的渲染代理，只负责绘制
+// 位置和下落速度在实体注册表的物品表中，由SimWorld::updateItems()更新
 class Item : public QGraphicsRectItem
 {
 public:
-    Item(qreal x, qreal y, ItemType type);
-
-    void applyGravity();
-    void move();
-    void checkPlatformCollision(Platform *platform);
+    explicit Item(ItemType type);
 
     ItemType getType() const { return type; }
 
+    // 每种物品的外观只画一次，由精灵缓存保存
     void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
+    const Sprite &sprite() const;
+    // 覆盖精灵的整个绘制范围，场景据此决定重绘哪些区域
+    QRectF boundingRect() const override;
 
 private:
-    ItemType type;
-    qreal yVelocity;
-    bool onGround;
+    QRectF spriteBounds() const;
+    void draw(QPainter *painter) const;
 
-    const qreal GRAVITY = 0.2; // 物品下落速度较慢
+    ItemType type;
 };
 
 #endif // ITEM_H
@@ -1,4 +1,5 @@
 #include <QApplication>
+#include <QCommandLineParser>
 #include "gamewindow.h"
 #include <iostream>
 #include <QMessageBox>
@@ -7,7 +8,30 @@ using namespace std;
 int main(int argc, char *argv[])
 {
     QApplication a(argc, argv);
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption tickRateOption("tick-rate", "逻辑帧率（60/120/240）", "hz", "60");
+    QCommandLineOption recordOption("record", "每局结束后把录像保存到该文件", "file");
+    QCommandLineOption replayOption("replay", "回放录像文件", "file");
+    QCommandLineOption rendererOption("renderer", "渲染方式：scene（QGraphicsView）或batched（批量渲染），游戏中按F3切换", "backend", "scene");
+    parser.addOption(tickRateOption);
+    parser.addOption(recordOption);
+    parser.addOption(replayOption);
+    parser.addOption(rendererOption);
+    parser.process(a);
+
     GameWindow w;
+    w.setTickRate(parser.value(tickRateOption).toInt());
+    w.setRecordPath(parser.value(recordOption));
+    if (parser.value(rendererOption) == "batched")
+    {
+        w.setRenderBackend(RenderBackend::BATCHED);
+    }
     w.show();
+    if (parser.isSet(replayOption))
+    {
+        w.startReplay(parser.value(replayOption));
+    }
     return a.exec();
 }
\ No newline at end of file
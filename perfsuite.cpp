@@ -0,0 +1,602 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream>
+#include <QVector>
+#include <algorithm>
+#include <cmath>
+#include "simworld.h"
+#include "replay.h"
+
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#include <psapi.h>
+#elif defined(Q_OS_UNIX)
+#include <sys/resource.h>
+#endif
+
+// 语料中的一场对局：有录像时按录像回放并逐帧校验，没有录像时按种子重新进行
+// AI互搏和人机对战中的人类玩家（ScriptedPlayer）都完全由种子决定，所以两种方式跑的是同一场对局
+struct CorpusMatch
+{
+    QString name;
+    GameMode mode = GameMode::AI_VS_AI;
+    quint32 seed = 1;
+    int tickRate = SIM_BASE_TICK_RATE;
+    qint64 maxTicks = 0;
+    QString replayPath;
+};
+
+// 一次运行的测量结果
+struct MatchMetrics
+{
+    qint64 ticks = 0;
+    int winnerID = 0;
+    quint32 checksum = 0;
+    qint64 wallNs = 0;
+    qint64 tickP50Ns = 0;
+    qint64 tickP99Ns = 0;
+    qint64 phaseNanos[SIM_PHASE_COUNT] = {};
+    qint64 peakMemoryKb = 0;
+    bool replayVerified = false;
+    QString error;                  // 对局与录像或前几次运行不一致时的说明
+};
+
+// --require-baseline模式下无法比较时的退出码，CTest据此把测试记为跳过而不是通过
+static const int SKIP_EXIT_CODE = 77;
+
+// 与基线比较时允许的相对增幅
+struct Thresholds
+{
+    double wallTime = 0.15;
+    double tickP50 = 0.15;
+    double tickP99 = 0.35;
+    double phase = 0.25;
+    double peakMemory = 0.20;
+    double minPhaseNsPerTick = 200;     // 比这更便宜的阶段误差太大，不比较
+};
+
+// 让峰值内存从当前用量重新开始统计，只有Linux支持
+static void resetPeakMemory()
+{
+#if defined(Q_OS_LINUX)
+    QFile file("/proc/self/clear_refs");
+    if (file.open(QIODevice::WriteOnly))
+        file.write("5");
+#endif
+}
+
+// 进程的峰值常驻内存（KB）；不支持重置的系统上是整个进程运行以来的峰值
+static qint64 peakMemoryKb()
+{
+#if defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return qint64(counters.PeakWorkingSetSize / 1024);
+    return 0;
+#elif defined(Q_OS_LINUX)
+    QFile file("/proc/self/status");
+    if (file.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        for (const QByteArray &line : file.readAll().split('\n'))
+        {
+            if (line.startsWith("VmHWM:"))
+                return line.mid(6).trimmed().split(' ').value(0).toLongLong();
+        }
+    }
+    return 0;
+#elif defined(Q_OS_UNIX)
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+#if defined(Q_OS_DARWIN)
+    return qint64(usage.ru_maxrss / 1024);  // macOS上的单位是字节
+#else
+    return qint64(usage.ru_maxrss);
+#endif
+#else
+    return 0;
+#endif
+}
+
+// 人机对战语料中的人类玩家：按种子生成的操作序列，每隔10到40个60Hz帧换一种按键组合
+// 和真人一样大多数时间在左右移动，经常开火，偶尔跳跃或下蹲；只看种子不看局面，录像可以重新生成
+class ScriptedPlayer
+{
+public:
+    ScriptedPlayer(quint32 seed, int tickRate)
+        : rng(seed), ticksPerBaseFrame(qMax(1, tickRate / SIM_BASE_TICK_RATE)) {}
+
+    quint8 next()
+    {
+        if (remaining-- > 0)
+            return keys;
+
+        keys = 0;
+        int direction = rng.bounded(100);
+        if (direction < 45)
+            keys |= INPUT_LEFT;
+        else if (direction < 90)
+            keys |= INPUT_RIGHT;
+        if (rng.bounded(100) < 25)
+            keys |= INPUT_JUMP;
+        else if (rng.bounded(100) < 10)
+            keys |= INPUT_CROUCH;
+        if (rng.bounded(100) < 50)
+            keys |= INPUT_FIRE;
+        remaining = rng.bounded(10, 41) * ticksPerBaseFrame - 1;
+        return keys;
+    }
+
+private:
+    QRandomGenerator rng;
+    int ticksPerBaseFrame;
+    int remaining = 0;
+    quint8 keys = 0;
+};
+
+// 最近秩法取百分位数，sorted必须已排序
+static qint64 percentile(const QVector<qint64> &sorted, double p)
+{
+    if (sorted.isEmpty())
+        return 0;
+    int rank = qBound(0, int(std::ceil(p * sorted.size())) - 1, sorted.size() - 1);
+    return sorted[rank];
+}
+
+// 完整地跑一场对局：与游戏相同，每帧调用一次SimWorld::step()，AI照常决策
+// 有录像时人类玩家使用录像中的输入，AI的决定必须与录像中记录的完全一致
+static MatchMetrics runMatch(const CorpusMatch &match, Replay *replay)
+{
+    MatchMetrics metrics;
+    GameMode mode = replay ? replay->getGameMode() : match.mode;
+    qint64 maxTicks = replay ? replay->getTickCount() : match.maxTicks;
+
+    resetPeakMemory();
+    {
+        SimWorld world;
+        world.setTickRate(replay ? replay->getTickRate() : match.tickRate);
+        world.setPhaseTiming(true);
+        world.reset(mode, replay ? replay->getSeed() : match.seed);
+        world.resetPhaseTiming();
+
+        QVector<qint64> tickNanos;
+        tickNanos.reserve(int(maxTicks));
+        if (replay)
+            replay->rewind();
+
+        TickInput input;
+        ScriptedPlayer human(match.seed, world.getTickRate());
+        QElapsedTimer clock;
+        clock.start();
+        while (world.isRunning() && metrics.ticks < maxTicks)
+        {
+            if (replay && !replay->next(input))
+                break;
+            if (!replay && mode == GameMode::PLAYER_VS_AI)
+                input.player[0] = human.next();
+
+            qint64 before = clock.nsecsElapsed();
+            world.step(input);
+            tickNanos.append(clock.nsecsElapsed() - before);
+            metrics.ticks++;
+
+            if (replay && world.getLastInput().pack() != input.pack())
+            {
+                metrics.error = QString("第%1帧的输入与录像不一致，AI的行为变了，需要用--record重新录制")
+                                    .arg(metrics.ticks);
+                break;
+            }
+        }
+        metrics.wallNs = clock.nsecsElapsed();
+
+        metrics.winnerID = world.getWinnerID();
+        metrics.checksum = world.stateChecksum();
+        for (int i = 0; i < SIM_PHASE_COUNT; i++)
+            metrics.phaseNanos[i] = world.getPhaseNanos(i);
+
+        std::sort(tickNanos.begin(), tickNanos.end());
+        metrics.tickP50Ns = percentile(tickNanos, 0.50);
+        metrics.tickP99Ns = percentile(tickNanos, 0.99);
+    }
+    metrics.peakMemoryKb = peakMemoryKb();
+
+    if (replay && metrics.error.isEmpty())
+    {
+        if (metrics.ticks != replay->getTickCount() || metrics.winnerID != replay->getWinnerID()
+            || metrics.checksum != replay->getChecksum())
+        {
+            metrics.error = QString("结果与录像不一致：帧数%1/%2，胜者%3/%4")
+                                .arg(metrics.ticks).arg(replay->getTickCount())
+                                .arg(metrics.winnerID).arg(replay->getWinnerID());
+        }
+        else
+        {
+            metrics.replayVerified = true;
+        }
+    }
+    return metrics;
+}
+
+// 按种子进行一场对局并保存为录像，人机对战中的人类玩家由ScriptedPlayer操作
+static bool recordMatch(const CorpusMatch &match, QString *error)
+{
+    SimWorld world;
+    world.setTickRate(match.tickRate);
+    world.reset(match.mode, match.seed);
+
+    Replay recording;
+    recording.begin(match.seed, world.getTickRate(), match.mode);
+    ScriptedPlayer human(match.seed, world.getTickRate());
+    TickInput input;
+    qint64 tick = 0;
+    while (world.isRunning() && tick < match.maxTicks)
+    {
+        if (match.mode == GameMode::PLAYER_VS_AI)
+            input.player[0] = human.next();
+        world.step(input);
+        recording.append(world.getLastInput());
+        tick++;
+    }
+    recording.setResult(world.getWinnerID(), world.stateChecksum());
+
+    QDir().mkpath(QFileInfo(match.replayPath).absolutePath());
+    return recording.save(match.replayPath, error);
+}
+
+static bool loadJson(const QString &path, QJsonObject &object, QString *error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        *error = file.errorString();
+        return false;
+    }
+    QJsonParseError parseError;
+    QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (!document.isObject())
+    {
+        *error = parseError.errorString();
+        return false;
+    }
+    object = document.object();
+    return true;
+}
+
+static bool saveJson(const QString &path, const QJsonObject &object, QString *error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly) || file.write(QJsonDocument(object).toJson(QJsonDocument::Indented)) < 0)
+    {
+        *error = file.errorString();
+        return false;
+    }
+    return true;
+}
+
+// 读取语料清单，录像路径相对于清单所在的目录
+static bool loadCorpus(const QString &path, QVector<CorpusMatch> &corpus, QString *error)
+{
+    QJsonObject root;
+    if (!loadJson(path, root, error))
+        return false;
+
+    QDir dir = QFileInfo(path).absoluteDir();
+    for (const QJsonValue &value : root.value("matches").toArray())
+    {
+        QJsonObject entry = value.toObject();
+        CorpusMatch match;
+        match.name = entry.value("name").toString();
+        QString mode = entry.value("mode").toString("ai_vs_ai");
+        if (mode == "player_vs_ai")
+        {
+            match.mode = GameMode::PLAYER_VS_AI;
+        }
+        else if (mode != "ai_vs_ai")
+        {
+            *error = QString("%1: 不支持的模式%2").arg(match.name, mode);
+            return false;
+        }
+        match.seed = quint32(entry.value("seed").toInt(1));
+        match.tickRate = entry.value("tick_rate").toInt(SIM_BASE_TICK_RATE);
+        match.maxTicks = qint64(entry.value("max_seconds").toInt(600)) * match.tickRate;
+        match.replayPath = dir.filePath(entry.value("replay").toString(match.name + ".rpl"));
+        if (match.name.isEmpty())
+        {
+            *error = "语料中有一场对局没有名字";
+            return false;
+        }
+        corpus.append(match);
+    }
+    if (corpus.isEmpty())
+    {
+        *error = "语料为空";
+        return false;
+    }
+    return true;
+}
+
+static Thresholds loadThresholds(const QJsonObject &baseline)
+{
+    Thresholds thresholds;
+    QJsonObject json = baseline.value("thresholds").toObject();
+    thresholds.wallTime = json.value("wall_time").toDouble(thresholds.wallTime);
+    thresholds.tickP50 = json.value("tick_p50").toDouble(thresholds.tickP50);
+    thresholds.tickP99 = json.value("tick_p99").toDouble(thresholds.tickP99);
+    thresholds.phase = json.value("phase").toDouble(thresholds.phase);
+    thresholds.peakMemory = json.value("peak_memory").toDouble(thresholds.peakMemory);
+    thresholds.minPhaseNsPerTick = json.value("min_phase_ns_per_tick").toDouble(thresholds.minPhaseNsPerTick);
+    return thresholds;
+}
+
+static QJsonObject metricsToJson(const CorpusMatch &match, const MatchMetrics &metrics)
+{
+    QJsonObject json;
+    json.insert("seed", qint64(match.seed));
+    json.insert("tick_rate", match.tickRate);
+    json.insert("ticks", metrics.ticks);
+    json.insert("winner", metrics.winnerID);
+    json.insert("checksum", QString("%1").arg(metrics.checksum, 8, 16, QChar('0')));
+    json.insert("wall_ms", metrics.wallNs / 1e6);
+    json.insert("tick_p50_ns", metrics.tickP50Ns);
+    json.insert("tick_p99_ns", metrics.tickP99Ns);
+    QJsonObject phases;
+    for (int i = 0; i < SIM_PHASE_COUNT; i++)
+    {
+        double perTick = metrics.ticks > 0 ? double(metrics.phaseNanos[i]) / metrics.ticks : 0.0;
+        phases.insert(SimWorld::phaseName(i), perTick);
+    }
+    json.insert("phase_ns_per_tick", phases);
+    json.insert("peak_memory_kb", metrics.peakMemoryKb);
+    return json;
+}
+
+// 与基线中的同名对局比较，返回超出阈值的指标
+static QStringList compare(const QJsonObject &current, const QJsonObject &base, const Thresholds &thresholds)
+{
+    QStringList regressions;
+    auto check = [&](const QString &label, double now, double before, double threshold) {
+        if (before > 0 && now > before * (1 + threshold))
+        {
+            regressions.append(QString("%1: %2 -> %3 (+%4%, 阈值%5%)")
+                                   .arg(label).arg(before, 0, 'f', 1).arg(now, 0, 'f', 1)
+                                   .arg(100 * (now / before - 1), 0, 'f', 1).arg(100 * threshold, 0, 'f', 0));
+        }
+    };
+
+    check("wall_ms", current.value("wall_ms").toDouble(), base.value("wall_ms").toDouble(), thresholds.wallTime);
+    check("tick_p50_ns", current.value("tick_p50_ns").toDouble(), base.value("tick_p50_ns").toDouble(),
+          thresholds.tickP50);
+    check("tick_p99_ns", current.value("tick_p99_ns").toDouble(), base.value("tick_p99_ns").toDouble(),
+          thresholds.tickP99);
+    check("peak_memory_kb", current.value("peak_memory_kb").toDouble(), base.value("peak_memory_kb").toDouble(),
+          thresholds.peakMemory);
+
+    QJsonObject phases = current.value("phase_ns_per_tick").toObject();
+    QJsonObject basePhases = base.value("phase_ns_per_tick").toObject();
+    for (int i = 0; i < SIM_PHASE_COUNT; i++)
+    {
+        QString name = SimWorld::phaseName(i);
+        double before = basePhases.value(name).toDouble();
+        if (before >= thresholds.minPhaseNsPerTick)
+            check("phase." + name, phases.value(name).toDouble(), before, thresholds.phase);
+    }
+    return regressions;
+}
+
+// 性能回归测试：回放固定的对局语料，测量总耗时、每帧耗时的p50/p99、各阶段耗时和峰值内存，
+// 与检入的基线比较，超过阈值时返回1，供CTest调用
+// 与合成场景的微基准不同，这里测的是真实对局中AI、碰撞和物品生成的实际比例
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+    QCoreApplication::setApplicationName("HW1_1_perf");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("基于录像的性能回归测试");
+    parser.addHelpOption();
+    QCommandLineOption corpusOption("corpus", "对局语料清单", "file", "perf/corpus.json");
+    QCommandLineOption baselineOption("baseline", "基线文件", "file", "perf/baseline.json");
+    QCommandLineOption repeatOption("repeat", "每场对局运行的次数，取总耗时最短的一次", "n", "3");
+    QCommandLineOption outputOption("output", "把本次的测量结果写成JSON", "file");
+    QCommandLineOption updateOption("update-baseline", "用本次的测量结果更新基线（保留阈值）");
+    QCommandLineOption recordOption("record", "按种子重新录制语料中的所有录像后退出");
+    QCommandLineOption requireOption("require-baseline",
+                                     "CTest模式：缺少录像或基线时视为失败，没有基线或未开启优化时跳过");
+    parser.addOption(corpusOption);
+    parser.addOption(baselineOption);
+    parser.addOption(repeatOption);
+    parser.addOption(outputOption);
+    parser.addOption(updateOption);
+    parser.addOption(recordOption);
+    parser.addOption(requireOption);
+    parser.process(a);
+    bool requireBaseline = parser.isSet(requireOption);
+
+    QTextStream out(stdout);
+    QString error;
+    QVector<CorpusMatch> corpus;
+    if (!loadCorpus(parser.value(corpusOption), corpus, &error))
+    {
+        out << QString("无法加载语料%1: %2\n").arg(parser.value(corpusOption), error);
+        return 2;
+    }
+
+    if (parser.isSet(recordOption))
+    {
+        for (const CorpusMatch &match : corpus)
+        {
+            if (!recordMatch(match, &error))
+            {
+                out << QString("无法保存录像%1: %2\n").arg(match.replayPath, error);
+                return 2;
+            }
+            out << QString("已录制%1\n").arg(match.replayPath);
+        }
+        return 0;
+    }
+
+    // 基线缺失时只测量不比较；CTest模式下什么都比较不了，记为跳过
+    QString baselinePath = parser.value(baselineOption);
+    QJsonObject baseline;
+    if (!loadJson(baselinePath, baseline, &error) && !parser.isSet(updateOption))
+    {
+        out << QString("无法加载基线%1: %2，只测量不比较\n").arg(baselinePath, error);
+        if (requireBaseline)
+            return SKIP_EXIT_CODE;
+    }
+    Thresholds thresholds = loadThresholds(baseline);
+    QJsonObject baseMatches = baseline.value("matches").toObject();
+    if (requireBaseline && baseMatches.isEmpty())
+    {
+        out << QString("基线%1中没有任何对局，请用--record和--update-baseline生成后检入，跳过\n").arg(baselinePath);
+        return SKIP_EXIT_CODE;
+    }
+
+    // 没有开启优化时耗时没有参考价值，只校验对局本身；CTest模式下记为跳过
+#ifdef NDEBUG
+    bool compareTimes = true;
+#else
+    bool compareTimes = false;
+    out << "未开启优化（没有定义NDEBUG），只校验对局，不与基线比较\n";
+    if (requireBaseline)
+        return SKIP_EXIT_CODE;
+#endif
+
+    int repeat = qMax(1, parser.value(repeatOption).toInt());
+    int failures = 0;
+    int errors = 0;                 // 录像加载失败或对局不一致，这时不能更新基线
+    QJsonObject measured;
+    QJsonArray report;
+    for (const CorpusMatch &match : corpus)
+    {
+        // 有录像就按录像回放，否则按种子重新进行；CTest模式下录像必须检入
+        Replay replay;
+        bool hasReplay = QFileInfo::exists(match.replayPath);
+        if (!hasReplay && requireBaseline)
+        {
+            out << QString("%1: 缺少录像%2，请用--record录制后检入\n").arg(match.name, match.replayPath);
+            failures++;
+            errors++;
+            continue;
+        }
+        if (hasReplay && !replay.load(match.replayPath, &error))
+        {
+            out << QString("%1: 无法加载录像%2: %3\n").arg(match.name, match.replayPath, error);
+            failures++;
+            errors++;
+            continue;
+        }
+
+        // 多次运行取最快的一次，每次的对局必须完全相同
+        MatchMetrics best;
+        for (int run = 0; run < repeat; run++)
+        {
+            MatchMetrics metrics = runMatch(match, hasReplay ? &replay : nullptr);
+            if (run > 0 && metrics.error.isEmpty() && metrics.checksum != best.checksum)
+                metrics.error = "多次运行的结果不一致，模拟不是确定的";
+            if (run == 0 || !metrics.error.isEmpty() || metrics.wallNs < best.wallNs)
+                best = metrics;
+            if (!best.error.isEmpty())
+                break;
+        }
+
+        QJsonObject current = metricsToJson(match, best);
+        measured.insert(match.name, current);
+
+        QString status = "ok";
+        QStringList problems;
+        QJsonObject base = baseMatches.value(match.name).toObject();
+        if (!best.error.isEmpty())
+        {
+            status = "error";
+            problems.append(best.error);
+            errors++;
+        }
+        else if (base.isEmpty())
+        {
+            status = "no_baseline";
+        }
+        else if (qint64(base.value("ticks").toDouble()) != best.ticks
+                 || base.value("checksum").toString() != current.value("checksum").toString())
+        {
+            // 对局变了，耗时不再可比，需要重新录制语料并更新基线
+            status = "changed";
+            problems.append(QString("对局与基线不同（帧数%1/%2），请用--record和--update-baseline更新")
+                                .arg(best.ticks).arg(qint64(base.value("ticks").toDouble())));
+        }
+        else if (compareTimes)
+        {
+            problems = compare(current, base, thresholds);
+            if (!problems.isEmpty())
+                status = "regression";
+        }
+        // CTest模式下语料中的每场对局都必须有基线，否则这场对局等于没有测
+        if (status == "error" || status == "changed" || status == "regression"
+            || (status == "no_baseline" && requireBaseline))
+            failures++;
+
+        out << QString("%1 %2: 帧数=%3 用时=%4ms p50=%5ns p99=%6ns 内存=%7KB %8%9\n")
+                   .arg(match.name, -20).arg(status, -11).arg(best.ticks)
+                   .arg(best.wallNs / 1e6, 0, 'f', 1).arg(best.tickP50Ns).arg(best.tickP99Ns)
+                   .arg(best.peakMemoryKb).arg(best.replayVerified ? "录像已校验" : "按种子重新生成")
+                   .arg(problems.isEmpty() ? QString() : "\n    " + problems.join("\n    "));
+        out.flush();
+
+        current.insert("name", match.name);
+        current.insert("status", status);
+        current.insert("replay_verified", best.replayVerified);
+        current.insert("problems", QJsonArray::fromStringList(problems));
+        report.append(current);
+    }
+
+    if (parser.isSet(outputOption))
+    {
+        QJsonObject root;
+        root.insert("suite", "HW1_1_perf");
+        root.insert("repeat", repeat);
+        root.insert("matches", report);
+        if (!saveJson(parser.value(outputOption), root, &error))
+            out << QString("无法写入%1: %2\n").arg(parser.value(outputOption), error);
+    }
+
+    if (parser.isSet(updateOption))
+    {
+        if (errors > 0)
+        {
+            out << "有对局出错，不更新基线\n";
+            return 1;
+        }
+
+        // 阈值由人工维护，只替换测量值；新建基线时写入默认阈值
+        if (!baseline.contains("thresholds"))
+        {
+            QJsonObject json;
+            json.insert("wall_time", thresholds.wallTime);
+            json.insert("tick_p50", thresholds.tickP50);
+            json.insert("tick_p99", thresholds.tickP99);
+            json.insert("phase", thresholds.phase);
+            json.insert("peak_memory", thresholds.peakMemory);
+            json.insert("min_phase_ns_per_tick", thresholds.minPhaseNsPerTick);
+            baseline.insert("thresholds", json);
+        }
+        baseline.insert("matches", measured);
+        if (!saveJson(baselinePath, baseline, &error))
+        {
+            out << QString("无法写入基线%1: %2\n").arg(baselinePath, error);
+            return 2;
+        }
+        out << QString("已更新基线%1\n").arg(baselinePath);
+        return 0;
+    }
+
+    out << QString("共%1场，%2场失败\n").arg(corpus.size()).arg(failures);
+    out.flush();
+    return failures > 0 ? 1 : 0;
+}
@@ -1,13 +1,13 @@
 #include "platform.h"
 #include <QPainter>
 #include <QBrush>
+#include "assetmanager.h"
 
 // 第一个构造函数 - 用于 GameWindow::createPlatforms() 中的调用
 Platform::Platform(PlatformType type, qreal width, qreal height)
     : type(type)
 {
     setRect(0, 0, width, height);
-    loadPlatformImage(); // 加载对应类型的图片
 }
 
 // 第二个构造函数 - 兼容其他可能的调用
@@ -16,7 +16,6 @@ Platform::Platform(qreal x, qreal y, qreal width, qreal height, PlatformType typ
 {
     setRect(0, 0, width, height);
     setPos(x, y);
-    loadPlatformImage(); // 加载对应类型的图片
 }
 
 void Platform::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
@@ -24,15 +23,12 @@ void Platform::paint(QPainter *painter, const QStyleOptionGraphicsItem *option,
     Q_UNUSED(option);
     Q_UNUSED(widget);
 
+    // 缩放到平台大小的贴图，同样尺寸的平台共用一张，只缩放一次
+    QRectF targetRect = rect();
+    QPixmap platformImage = AssetManager::instance().pixmap(texturePath(type), targetRect.size().toSize());
     if (!platformImage.isNull())
     {
-        // 平铺图片填充整个平台区域
-        QRectF targetRect = rect();
-
-        // 方法1：缩放图片以适应平台大小
-        QPixmap scaledImage = platformImage.scaled(targetRect.width(), targetRect.height(),
-                                                   Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
-        painter->drawPixmap(targetRect.toRect(), scaledImage);
+        painter->drawPixmap(targetRect.toRect(), platformImage);
     }
     else
     {
@@ -54,32 +50,16 @@ void Platform::paint(QPainter *painter, const QStyleOptionGraphicsItem *option,
         painter->drawRect(rect());
     }
 }
-#include <QMessageBox>
-void Platform::loadPlatformImage()
+QString Platform::texturePath(PlatformType type)
 {
-    QString imagePath;
-
     switch (type)
     {
     case PlatformType::GROUND:
-        imagePath = "./images/ground.png";
-        break;
+        return "./images/ground.png";
     case PlatformType::GRASS:
-        imagePath = "./images/grass.png";
-        break;
+        return "./images/grass.png";
     case PlatformType::ICE:
-        imagePath = "./images/ice.jpeg";
-        break;
-    }
-
-    platformImage.load(imagePath);
-    if (platformImage.isNull())
-    {
-        // QMessageBox::warning(nullptr, "错误", "平台图片未找到，请检查路径: " + imagePath);
-    }
-    else
-    {
-        // qDebug() << "平台图片加载成功:" << imagePath;
-        // QMessageBox::information(nullptr, "调试", "平台图片加载成功: " + imagePath);
+        return "./images/ice.jpeg";
     }
+    return QString();
 }
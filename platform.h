@@ -22,10 +22,11 @@ public:
 
     void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
 
+    // 每种平台的贴图，由资源管理器统一加载，所有同类平台共用一张
+    static QString texturePath(PlatformType type);
+
 private:
     PlatformType type;
-    QPixmap platformImage;
-    void loadPlatformImage();
 };
 
 #endif // PLATFORM_H
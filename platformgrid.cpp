@@ -0,0 +1,92 @@
+#include "platformgrid.h"
+#include <algorithm>
+#include <cmath>
+
+PlatformGrid::PlatformGrid(qreal cellSize)
+    : cellSize(cellSize), columns(0), rows(0), currentStamp(0)
+{
+}
+
+void PlatformGrid::clear()
+{
+    columns = 0;
+    rows = 0;
+    platformRects.clear();
+    cells.clear();
+    visitStamp.clear();
+    currentStamp = 0;
+}
+
+int PlatformGrid::cellX(qreal x) const
+{
+    int column = int(std::floor((x - bounds.left()) / cellSize));
+    return qBound(0, column, columns - 1);
+}
+
+int PlatformGrid::cellY(qreal y) const
+{
+    int row = int(std::floor((y - bounds.top()) / cellSize));
+    return qBound(0, row, rows - 1);
+}
+
+void PlatformGrid::build(const EntityTable &platforms, const QRectF &gridBounds)
+{
+    clear();
+    bounds = gridBounds;
+    columns = qMax(1, int(std::ceil(bounds.width() / cellSize)));
+    rows = qMax(1, int(std::ceil(bounds.height() / cellSize)));
+    cells.resize(columns * rows);
+
+    for (int index = 0; index < platforms.size(); index++)
+    {
+        QRectF rect = platforms.bounds(index);
+        platformRects.append(rect);
+
+        for (int row = cellY(rect.top()); row <= cellY(rect.bottom()); row++)
+        {
+            for (int column = cellX(rect.left()); column <= cellX(rect.right()); column++)
+            {
+                cells[row * columns + column].append(index);
+            }
+        }
+    }
+
+    visitStamp.fill(0, platformRects.size());
+}
+
+void PlatformGrid::query(const QRectF &rect, QVector<int> &result) const
+{
+    result.clear();
+    if (platformRects.isEmpty())
+        return;
+
+    // 每次查询换一个标记值，避免清空整个去重数组
+    currentStamp++;
+    if (currentStamp == 0)
+    {
+        visitStamp.fill(0);
+        currentStamp = 1;
+    }
+
+    for (int row = cellY(rect.top()); row <= cellY(rect.bottom()); row++)
+    {
+        for (int column = cellX(rect.left()); column <= cellX(rect.right()); column++)
+        {
+            for (int index : cells[row * columns + column])
+            {
+                if (visitStamp[index] == currentStamp)
+                    continue;
+                visitStamp[index] = currentStamp;
+
+                // 边缘刚好接触也算重叠，由精确检测再判断
+                const QRectF &platformRect = platformRects[index];
+                if (platformRect.left() <= rect.right() && rect.left() <= platformRect.right() &&
+                    platformRect.top() <= rect.bottom() && rect.top() <= platformRect.bottom())
+                    result.append(index);
+            }
+        }
+    }
+
+    // 保持与逐行遍历平台表相同的顺序，碰撞处理的结果才不会改变
+    std::sort(result.begin(), result.end());
+}
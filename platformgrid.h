@@ -0,0 +1,40 @@
+#ifndef PLATFORMGRID_H
+#define PLATFORMGRID_H
+
+#include <QRectF>
+#include <QVector>
+#include "entityregistry.h"
+
+// 静态平台的均匀网格：平台在一局中不会移动，因此只在创建平台后建一次
+// 查询时只检查矩形覆盖到的格子，返回与之可能重叠的平台，
+// 避免每个实体每帧都和所有平台逐一比较
+// 超出网格范围的部分归入边缘的格子，所以场地外的实体也能查到
+class PlatformGrid
+{
+public:
+    explicit PlatformGrid(qreal cellSize = 128);
+
+    // 按平台表中各行的包围盒建立网格，bounds一般为整个场地
+    void build(const EntityTable &platforms, const QRectF &bounds);
+    void clear();
+
+    // 找出包围盒与rect重叠的平台，把它们在平台表中的行号按升序写入result
+    void query(const QRectF &rect, QVector<int> &result) const;
+
+private:
+    int cellX(qreal x) const;
+    int cellY(qreal y) const;
+
+    qreal cellSize;
+    QRectF bounds;
+    int columns;
+    int rows;
+    QVector<QRectF> platformRects;      // 建网格时缓存的平台包围盒，下标即平台表的行号
+    QVector<QVector<int>> cells;        // 每个格子里的平台行号
+
+    // 查询时去重：同一个平台可能跨多个格子
+    mutable QVector<quint32> visitStamp;
+    mutable quint32 currentStamp;
+};
+
+#endif // PLATFORMGRID_H
@@ -1,228 +1,187 @@
 #include "player.h"
-#include <QPainter>
-#include <QBrush>
-#include <QDebug> // 添加这行
-#include <QDir>   // 添加这行
 #include "armor.h"
 
-Player::Player(qreal x, qreal y, QColor color, int playerID)
-    : playerID(playerID), health(100), xVelocity(0), yVelocity(0),
-      speed(5), jumpForce(-15), onGround(false), facingRight(playerID == 1),
-      crouching(false), hidden(false), color(color),
-      currentPlatform(PlatformType::GROUND), hasAdrenaline(false),
-      armor(nullptr) // 初始化护甲为空
+Player::Player(EntityRegistry &registry, qreal x, qreal y, QColor color, int playerID)
+    : registry(registry), id(registry.create(EntityKind::PLAYER)), playerID(playerID),
+      speed(5), jumpForce(-15), color(color),
+      currentPlatform(PlatformType::GROUND), speedMultiplier(1.0)
 {
-    // 设置玩家矩形
-    setRect(0, 0, PLAYER_WIDTH, PLAYER_HEIGHT);
-    setPos(x, y);
-    setBrush(QBrush(color));
-
-    // 创建默认武器（拳头）
-    weapon = new Weapon(WeaponType::FIST);
-
-    // 创建肾上腺素计时器
-    adrenalineTimer = new QTimer(this);
-    connect(adrenalineTimer, &QTimer::timeout, this, &Player::endAdrenalineEffect);
-
-    adrenalineHealTimer = new QTimer(this);
-    connect(adrenalineHealTimer, &QTimer::timeout, this, &Player::adrenalineHeal);
-
-    useImage = false;
+    // 设置玩家的碰撞箱和位置
+    EntityTable &table = players();
+    int r = row();
+    table.x[r] = x;
+    table.y[r] = y;
+    table.prevX[r] = x;
+    table.prevY[r] = y;
+    table.width[r] = PLAYER_WIDTH;
+    table.height[r] = PLAYER_HEIGHT;
+    table.health[r] = 100;
+    table.owner[r] = playerID;
+    table.setFlag(r, ENTITY_FACING_RIGHT, playerID == 1);
+
+    // 默认武器是拳头，没有护甲（注册表新建的行已经是这样）
 }
 
 Player::~Player()
 {
-    delete weapon;
-    delete adrenalineTimer;
-    delete adrenalineHealTimer;
-    if (armor)
-        delete armor;
+    // 渲染代理随实体一起删除
+    registry.destroy(id);
 }
 
 void Player::moveLeft()
 {
-    if (crouching)
+    if (isCrouching())
         return;
 
-    facingRight = false;
+    setFacingRight(false);
 
     // 在冰面上移动更快，增加差异性
     if (currentPlatform == PlatformType::ICE)
     {
-        xVelocity = -speed * 1.8; // 增加冰面速度加成，更明显
-    }
-    // 肾上腺素状态下移动更快
-    else if (hasAdrenaline)
-    {
-        xVelocity = -speed * 1.5;
+        setXVelocity(-speed * 1.8); // 增加冰面速度加成，更明显
     }
+    // 肾上腺素等状态效果下移动更快
     else
     {
-        xVelocity = -speed;
+        setXVelocity(-speed * speedMultiplier);
     }
 }
 
 void Player::moveRight()
 {
-    if (crouching)
+    if (isCrouching())
         return;
 
-    facingRight = true;
+    setFacingRight(true);
 
     // 在冰面上移动更快，增加差异性
     if (currentPlatform == PlatformType::ICE)
     {
-        xVelocity = speed * 1.8; // 增加冰面速度加成，更明显
-    }
-    // 肾上腺素状态下移动更快
-    else if (hasAdrenaline)
-    {
-        xVelocity = speed * 1.5;
+        setXVelocity(speed * 1.8); // 增加冰面速度加成，更明显
     }
+    // 肾上腺素等状态效果下移动更快
     else
     {
-        xVelocity = speed;
+        setXVelocity(speed * speedMultiplier);
     }
 }
 
 void Player::stopMoving()
 {
     // 立即停止水平移动
-    xVelocity = 0;
+    setXVelocity(0);
 }
 
 void Player::crouch(bool isCrouching)
 {
-    if (isCrouching && !crouching)
+    if (isCrouching && !this->isCrouching())
     {
         // 进入下蹲状态
-        crouching = true;
+        setFlag(ENTITY_CROUCHING, true);
 
         // 记住当前底部位置，用于保持玩家"脚"的位置不变
-        qreal bottomY = y() + rect().height();
+        qreal bottomY = y() + height();
 
         // 修改碰撞箱为下蹲状态
-        setRect(0, 0, PLAYER_WIDTH, CROUCHING_HEIGHT);
+        players().height[row()] = CROUCHING_HEIGHT;
 
         // 调整Y坐标，使玩家底部位置保持不变
         setY(bottomY - CROUCHING_HEIGHT);
 
-        // 在草地上下蹲时隐身效果更明显
-        if (currentPlatform == PlatformType::GRASS)
-        {
-            hidden = true;
-            setOpacity(0.3); // 更明显的透明效果
-        }
-        else
-        {
-            hidden = false;
-            setOpacity(1.0);
-        }
+        // 在草地上下蹲时隐身效果更明显（渲染代理按此标志调整透明度）
+        setFlag(ENTITY_HIDDEN, currentPlatform == PlatformType::GRASS);
     }
-    else if (!isCrouching && crouching)
+    else if (!isCrouching && this->isCrouching())
     {
         // 离开下蹲状态
-        crouching = false;
-        hidden = false;
-        setOpacity(1.0);
+        setFlag(ENTITY_CROUCHING, false);
+        setFlag(ENTITY_HIDDEN, false);
 
         // 记住当前底部位置，用于保持玩家"脚"的位置不变
-        qreal bottomY = y() + rect().height();
+        qreal bottomY = y() + height();
 
         // 恢复正常高度
-        setRect(0, 0, PLAYER_WIDTH, PLAYER_HEIGHT);
+        players().height[row()] = PLAYER_HEIGHT;
 
         // 调整Y坐标，使玩家底部位置保持不变
         setY(bottomY - PLAYER_HEIGHT);
     }
 }
 
-void Player::fire(QList<Projectile *> &projectiles, QGraphicsScene *scene)
+void Player::fire(ProjectilePool &pool, qint64 nowMs)
 {
-    if (weapon)
-    {
-        Projectile *proj = weapon->fire(x() + rect().width() / 2, y() + rect().height() / 2, facingRight, playerID);
-
-        // 检查武器弹药是否用光
-        if (weapon->isAmmoEmpty())
-        {
-            // 删除当前武器，切换回拳头
-            delete weapon;
-            weapon = new Weapon(WeaponType::FIST);
-        }
+    // 投射物直接加入对象池的投射物表
+    Weapon &current = weapon();
+    current.fire(pool, x() + width() / 2, y() + height() / 2, isFacingRight(), playerID, nowMs);
 
-        if (proj)
-        {
-            projectiles.append(proj);
-            scene->addItem(proj);
-        }
+    // 检查武器弹药是否用光
+    if (current.isAmmoEmpty())
+    {
+        // 切换回拳头
+        current = Weapon(WeaponType::FIST);
     }
 }
 
-void Player::applyGravity()
+void Player::applyGravity(qreal dt)
 {
-    if (!onGround)
+    if (!isOnGround())
     {
-        yVelocity += GRAVITY;
+        players().vy[row()] += GRAVITY * dt;
     }
 }
 
-void Player::move()
+void Player::move(qreal dt)
 {
-    // 保存当前位置以检查碰撞
-    qreal oldX = x();
-    qreal oldY = y();
+    EntityTable &table = players();
+    int r = row();
 
     // 应用速度限制，防止速度过高导致的穿墙问题
     const qreal MAX_VELOCITY = 20.0;
-    if (xVelocity > MAX_VELOCITY)
-        xVelocity = MAX_VELOCITY;
-    if (xVelocity < -MAX_VELOCITY)
-        xVelocity = -MAX_VELOCITY;
-    if (yVelocity > MAX_VELOCITY)
-        yVelocity = MAX_VELOCITY;
-    if (yVelocity < -MAX_VELOCITY)
-        yVelocity = -MAX_VELOCITY;
+    table.vx[r] = qBound(-MAX_VELOCITY, table.vx[r], MAX_VELOCITY);
+    table.vy[r] = qBound(-MAX_VELOCITY, table.vy[r], MAX_VELOCITY);
 
     // 应用移动
-    setPos(x() + xVelocity, y() + yVelocity);
+    table.x[r] += table.vx[r] * dt;
+    table.y[r] += table.vy[r] * dt;
 
     // 边界检查
-    if (x() < 0)
+    if (table.x[r] < 0)
     {
-        setX(0);
+        table.x[r] = 0;
     }
-    else if (x() + rect().width() > 1200)
+    else if (table.x[r] + table.width[r] > 1200)
     {
-        setX(1200 - rect().width());
+        table.x[r] = 1200 - table.width[r];
     }
 
     // 添加顶部和底部边界检查
-    if (y() < 0)
+    if (table.y[r] < 0)
     {
-        setY(0);
-        yVelocity = 0; // 防止继续向上移动
+        table.y[r] = 0;
+        table.vy[r] = 0; // 防止继续向上移动
     }
-    else if (y() + rect().height() > 800)
+    else if (table.y[r] + table.height[r] > 800)
     {
-        setY(800 - rect().height());
-        yVelocity = 0;
-        onGround = true; // 着陆在底部边界
+        table.y[r] = 800 - table.height[r];
+        table.vy[r] = 0;
+        setFlag(ENTITY_ON_GROUND, true); // 着陆在底部边界
     }
 }
 
-void Player::checkPlatformCollision(Platform *platform)
+void Player::checkPlatformCollision(const EntityTable &platforms, int platformRow, qreal dt)
 {
-    if (collidesWithItem(platform))
+    if (registry.collide(EntityKind::PLAYER, row(), EntityKind::PLATFORM, platformRow))
     {
-        QRectF playerRect = sceneBoundingRect();
-        QRectF platformRect = platform->sceneBoundingRect();
+        QRectF playerRect = bounds();
+        QRectF platformRect = platforms.bounds(platformRow);
+        qreal xVelocity = getXVelocity();
+        qreal yVelocity = getYVelocity();
 
         // 计算上一帧位置
-        qreal prevBottom = playerRect.bottom() - yVelocity;
-        qreal prevTop = playerRect.top() - yVelocity;
-        qreal prevRight = playerRect.right() - xVelocity;
-        qreal prevLeft = playerRect.left() - xVelocity;
+        qreal prevBottom = playerRect.bottom() - yVelocity * dt;
+        qreal prevTop = playerRect.top() - yVelocity * dt;
+        qreal prevRight = playerRect.right() - xVelocity * dt;
+        qreal prevLeft = playerRect.left() - xVelocity * dt;
 
         // 检查是否从上方着陆 - 改进的检测逻辑
         if ((prevBottom <= platformRect.top() ||
@@ -232,10 +191,11 @@ void Player::checkPlatformCollision(Platform *platform)
         { // 确保玩家正在下落或静止
 
             // 着陆在平台上
-            setY(platformRect.top() - rect().height());
-            yVelocity = 0;
-            onGround = true;
-            currentPlatform = platform->getType();
+            setY(platformRect.top() - height());
+            setYVelocity(0);
+            setFlag(ENTITY_ON_GROUND, true);
+            supportPlatform = platforms.id[platformRow];
+            currentPlatform = PlatformType(platforms.subtype[platformRow]);
             return; // 如果已确定站在平台上，提前返回
         }
         // 检查头部碰撞
@@ -244,15 +204,15 @@ void Player::checkPlatformCollision(Platform *platform)
         {
             // 头部碰到平台
             setY(platformRect.bottom());
-            yVelocity = 0;
+            setYVelocity(0);
         }
         // 检查水平碰撞 - 右侧
         else if (prevRight <= platformRect.left() &&
                  playerRect.right() >= platformRect.left())
         {
             // 右侧碰撞
-            setX(platformRect.left() - rect().width());
-            xVelocity = 0;
+            setX(platformRect.left() - width());
+            setXVelocity(0);
         }
         // 检查水平碰撞 - 左侧
         else if (prevLeft >= platformRect.right() &&
@@ -260,329 +220,139 @@ void Player::checkPlatformCollision(Platform *platform)
         {
             // 左侧碰撞
             setX(platformRect.right());
-            xVelocity = 0;
+            setXVelocity(0);
         }
     }
 }
 
-void Player::pickupItem(Item *item)
+void Player::pickupItem(ItemType type)
 {
-    switch (item->getType())
-    {
-    case ItemType::KNIFE:
-        delete weapon;
-        weapon = new Weapon(WeaponType::KNIFE);
-        break;
-    case ItemType::BALL:
-        delete weapon;
-        weapon = new Weapon(WeaponType::BALL);
-        break;
-    case ItemType::RIFLE:
-        delete weapon;
-        weapon = new Weapon(WeaponType::RIFLE);
-        break;
-    case ItemType::SNIPER:
-        delete weapon;
-        weapon = new Weapon(WeaponType::SNIPER);
-        break;
-    case ItemType::BANDAGE:
-        health = qMin(health + 25, 100);
-        break;
-    case ItemType::MEDKIT:
-        health = 100;
-        break;
-    case ItemType::ADRENALINE:
-        hasAdrenaline = true;
-        adrenalineTimer->start(10000);    // 10秒
-        adrenalineHealTimer->start(1000); // 每秒回血
-        break;
-    case ItemType::LIGHT_ARMOR:
-        equipArmor(new Armor(ArmorType::LIGHT));
-        break;
-    case ItemType::BULLETPROOF_VEST:
-        equipArmor(new Armor(ArmorType::BULLETPROOF));
-        break;
-    }
+    // 物品的效果全部来自ITEM_STATS，状态效果由游戏世界交给状态效果系统
+    const ItemStats &stats = itemStats(type);
+    if (stats.givesWeapon)
+        weapon() = Weapon(stats.weapon);
+    if (stats.heal > 0)
+        setHealth(qMin(getHealth() + stats.heal, 100));
+    if (stats.armor != ArmorType::NONE)
+        equipArmor(stats.armor);
 }
 
 void Player::takeDamage(int damage, ProjectileType projectileType)
 {
     // 检查是否有护甲可以减免伤害
-    if (armor)
+    if (hasArmor())
     {
-        damage = armor->absorbDamage(damage, projectileType);
+        damage = armor().absorbDamage(damage, projectileType);
 
         // 检查护甲是否已耗尽
-        if (armor->isExpired())
+        if (armor().isExpired())
         {
-            delete armor;
-            armor = nullptr;
+            equipArmor(ArmorType::NONE);
         }
     }
 
-    health -= damage;
-    if (health < 0)
-    {
-        health = 0;
-    }
+    setHealth(qMax(getHealth() - damage, 0));
 }
 
-void Player::equipArmor(Armor *newArmor)
+void Player::equipArmor(ArmorType type)
 {
-    if (armor)
-    {
-        delete armor;
-    }
-    armor = newArmor;
+    // 新护甲直接覆盖旧的
+    armor() = Armor(type);
 }
 
-void Player::updateEffects()
+void Player::updateEquipment()
 {
     // 检查护甲状态
-    if (armor && armor->isExpired())
+    if (armor().isExpired())
     {
-        delete armor;
-        armor = nullptr;
+        equipArmor(ArmorType::NONE);
     }
 
-    // 检查武器弹药状态
-    if (weapon && weapon->isAmmoEmpty() && weapon->getType() != WeaponType::FIST && weapon->getType() != WeaponType::KNIFE)
+    // 检查武器弹药状态（拳头和小刀弹药无限，不会用光）
+    Weapon &current = weapon();
+    if (current.isAmmoEmpty())
     {
-        delete weapon;
-        weapon = new Weapon(WeaponType::FIST);
+        current = Weapon(WeaponType::FIST);
     }
 }
 
-void Player::endAdrenalineEffect()
-{
-    hasAdrenaline = false;
-    adrenalineHealTimer->stop();
-}
-
-void Player::adrenalineHeal()
-{
-    health = qMin(health + 1, 100);
-}
-
 QString Player::getWeaponName() const
 {
-    if (!weapon)
-        return "无";
-
-    switch (weapon->getType())
-    {
-    case WeaponType::FIST:
-        return "拳头";
-    case WeaponType::KNIFE:
-        return "小刀";
-    case WeaponType::BALL:
-        return "实心球";
-    case WeaponType::RIFLE:
-        return "步枪";
-    case WeaponType::SNIPER:
-        return "狙击枪";
-    default:
-        return "未知";
-    }
+    return QString::fromUtf8(getWeapon().getStats().name);
 }
 
 QString Player::getArmorName() const
 {
-    if (!armor)
-        return "无";
-    return armor->getName();
+    // 没有护甲时显示“无”
+    return getArmor().getName();
 }
 
 void Player::jump()
 {
-    if (crouching || !onGround)
+    if (isCrouching() || !isOnGround())
         return;
 
-    yVelocity = jumpForce;
-    onGround = false;
+    setYVelocity(jumpForce);
+    setOnGround(false);
 }
 
-void Player::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+void Player::setOnGround(bool ground)
 {
-    Q_UNUSED(option);
-    Q_UNUSED(widget);
-
-    // 如果在草地上下蹲则半透明
-    if (hidden)
-    {
-        painter->setOpacity(0.3);
-    }
-    else
-    {
-        painter->setOpacity(1.0);
-    }
-
-    // 绘制玩家主体
-    if (useImage && !playerImage.isNull())
-    {
-        // 绘制图片
-        painter->drawPixmap(rect().toRect(), playerImage);
-    }
-    else
-    {
-        // 绘制玩家矩形
-        painter->setBrush(color);
-        painter->drawRect(rect());
-    }
-
-    // 绘制面部方向指示器（眼睛）
-    painter->setBrush(Qt::white);
-    if (facingRight)
-    {
-        painter->drawEllipse(rect().width() - 15, 10, 10, 10);
-    }
-    else
-    {
-        painter->drawEllipse(5, 10, 10, 10);
-    }
-
-    // 绘制护甲（如果有）
-    if (armor)
-    {
-        QColor armorColor;
-        switch (armor->getType())
-        {
-        case ArmorType::LIGHT:
-            armorColor = QColor(150, 150, 255, 180); // 蓝色半透明
-            break;
-        case ArmorType::BULLETPROOF:
-            armorColor = QColor(50, 150, 50, 180); // 绿色半透明
-            break;
-        default:
-            armorColor = QColor(0, 0, 0, 0);
-        }
-
-        // 绘制护甲轮廓
-        painter->setBrush(QBrush(armorColor));
-        painter->setPen(QPen(Qt::black, 1));
+    setFlag(ENTITY_ON_GROUND, ground);
+    if (!ground)
+        supportPlatform = EntityId();
+}
 
-        // 根据玩家大小调整护甲尺寸
-        qreal armorPadding = 2;
-        QRectF armorRect = rect().adjusted(armorPadding, armorPadding,
-                                           -armorPadding, -armorPadding);
-        painter->drawRect(armorRect);
+bool Player::hasGroundContact() const
+{
+    int supportRow = registry.rowOf(supportPlatform);
+    if (!isOnGround() || supportRow < 0 || getYVelocity() < 0)
+        return false;
+
+    QRectF body = bounds();
+    QRectF support = registry.table(EntityKind::PLATFORM).bounds(supportRow);
+    return body.right() >= support.left() && body.left() <= support.right() &&
+           qAbs(body.bottom() - support.top()) < 0.01;
+}
 
-        // 对于防弹衣，显示耐久度
-        if (armor->getType() == ArmorType::BULLETPROOF)
-        {
-            painter->setPen(Qt::white);
-            QFont font = painter->font();
-            font.setPointSize(6);
-            painter->setFont(font);
-            painter->drawText(armorRect, Qt::AlignTop | Qt::AlignHCenter,
-                              QString::number(armor->getDurability()));
-        }
-    }
+void Player::setPos(qreal newX, qreal newY)
+{
+    int r = row();
+    players().x[r] = newX;
+    players().y[r] = newY;
+}
 
-    // 绘制武器 - 增加武器尺寸和特征使其更明显
-    if (weapon)
-    {
-        QRectF weaponRect;
-        if (facingRight)
-        {
-            weaponRect = QRectF(rect().width() - 5, rect().height() / 2 - 5, 30, 10);
-        }
-        else
-        {
-            weaponRect = QRectF(-25, rect().height() / 2 - 5, 30, 10);
-        }
+void Player::setX(qreal newX)
+{
+    players().x[row()] = newX;
+}
 
-        switch (weapon->getType())
-        {
-        case WeaponType::FIST:
-            painter->setBrush(QColor(200, 150, 100));
-            if (facingRight)
-            {
-                painter->drawEllipse(rect().width() - 10, rect().height() / 2 - 5, 15, 15);
-            }
-            else
-            {
-                painter->drawEllipse(-5, rect().height() / 2 - 5, 15, 15);
-            }
-            break;
-        case WeaponType::KNIFE:
-            painter->setBrush(QColor(150, 150, 150));
-            painter->drawRect(weaponRect);
-            // 添加刀刃
-            painter->setBrush(QColor(220, 220, 220));
-            if (facingRight)
-            {
-                painter->drawRect(rect().width() + 15, rect().height() / 2 - 5, 10, 10);
-            }
-            else
-            {
-                painter->drawRect(-25, rect().height() / 2 - 5, 10, 10);
-            }
-            break;
-        case WeaponType::BALL:
-            painter->setBrush(QColor(50, 50, 50));
-            if (facingRight)
-            {
-                painter->drawEllipse(rect().width(), rect().height() / 2 - 10, 20, 20);
-            }
-            else
-            {
-                painter->drawEllipse(-20, rect().height() / 2 - 10, 20, 20);
-            }
-            break;
-        case WeaponType::RIFLE:
-            painter->setBrush(QColor(100, 100, 100));
-            painter->drawRect(weaponRect);
-            // 添加枪口
-            painter->setBrush(QColor(70, 70, 70));
-            if (facingRight)
-            {
-                painter->drawRect(rect().width() + 25, rect().height() / 2 - 2, 8, 4);
-            }
-            else
-            {
-                painter->drawRect(-33, rect().height() / 2 - 2, 8, 4);
-            }
-            break;
-        case WeaponType::SNIPER:
-            painter->setBrush(QColor(70, 70, 70));
-            painter->drawRect(weaponRect);
-            // 添加狙击枪特征（枪口和瞄准镜）
-            painter->setBrush(QColor(50, 50, 50));
-            if (facingRight)
-            {
-                painter->drawRect(rect().width() + 25, rect().height() / 2 - 2, 12, 4);
-                painter->drawEllipse(rect().width() + 10, rect().height() / 2 - 15, 10, 10);
-            }
-            else
-            {
-                painter->drawRect(-37, rect().height() / 2 - 2, 12, 4);
-                painter->drawEllipse(-20, rect().height() / 2 - 15, 10, 10);
-            }
-            break;
-        }
-    }
+void Player::setY(qreal newY)
+{
+    players().y[row()] = newY;
+}
 
-    // 绘制玩家ID
-    painter->setPen(Qt::white);
-    painter->drawText(rect().width() / 2 - 5, rect().height() - 10, QString::number(playerID));
+void Player::setXVelocity(qreal velocity)
+{
+    players().vx[row()] = velocity;
 }
-#include <QMessageBox>
-void Player::setPlayerImage(const QString &imagePath)
+
+void Player::setYVelocity(qreal velocity)
 {
-    // QMessageBox::information(nullptr, "调试", "尝试加载图片: " + imagePath);
+    players().vy[row()] = velocity;
+}
 
-    playerImage.load(imagePath);
-    if (!playerImage.isNull())
-    {
-        useImage = true;
+void Player::setFacingRight(bool facing)
+{
+    setFlag(ENTITY_FACING_RIGHT, facing);
+}
 
-        // 暂时不改变矩形大小，保持原有游戏逻辑
-        // setRect(0, 0, playerImage.width(), playerImage.height());
-    }
-    else
-    {
+void Player::setFlag(EntityFlag flag, bool on)
+{
+    players().setFlag(row(), flag, on);
+}
 
-        useImage = false;
-    }
+void Player::setHealth(int health)
+{
+    players().health[row()] = health;
 }
@@ -1,29 +1,23 @@
 #ifndef PLAYER_H
 #define PLAYER_H
 
-#include <QGraphicsRectItem>
-#include <QObject>
-#include <QGraphicsScene>
 #include <QColor>
-#include <QTimer>
-#include <QPixmap>
-#include <QPainter>
-#include <QDebug>
-#include <QDir>
+#include <QPointF>
+#include <QRectF>
+#include "entityregistry.h"
 #include "platform.h"
 #include "item.h"
 #include "weapon.h"
+#include "armor.h"
 #include "projectile.h"
 
-// 前向声明，避免循环引用
-class Armor;
-
-class Player : public QObject, public QGraphicsRectItem
+// 玩家控制器：位置、速度、尺寸、生命值、装备和状态标志都在实体注册表玩家表的一行中，
+// 这里只保存不常用的状态（速度参数、状态效果倍率、脚下平台等），并提供按行读写的接口
+// 绘制由PlayerSprite渲染代理负责
+class Player
 {
-    Q_OBJECT
-
 public:
-    Player(qreal x, qreal y, QColor color, int playerID);
+    Player(EntityRegistry &registry, qreal x, qreal y, QColor color, int playerID);
     ~Player();
 
     void moveLeft();
@@ -31,58 +25,90 @@ public:
     void stopMoving();
     void jump();
     void crouch(bool isCrouching);
-    void fire(QList<Projectile *> &projectiles, QGraphicsScene *scene);
-    void applyGravity();
-    void move();
-    void checkPlatformCollision(Platform *platform);
-    void pickupItem(Item *item);
+    // nowMs为游戏世界的模拟时间（毫秒），由帧计数换算而来，不读取系统时钟
+    void fire(ProjectilePool &pool, qint64 nowMs);
+    // dt为步长系数：60Hz时为1，120Hz时为0.5，速度单位仍是“像素/60Hz帧”
+    void applyGravity(qreal dt = 1.0);
+    void move(qreal dt = 1.0);
+    // 与平台表中第platformRow个平台做碰撞修正
+    void checkPlatformCollision(const EntityTable &platforms, int platformRow, qreal dt = 1.0);
+    void pickupItem(ItemType type);
     void takeDamage(int damage, ProjectileType projectileType = ProjectileType::BULLET);
-    void updateEffects();
-    void setOnGround(bool ground) { onGround = ground; }
+    // 移除损坏的护甲，弹药用光时换回拳头
+    void updateEquipment();
+
+    // 状态效果带来的移动速度倍率，由游戏世界每帧从状态效果系统同步
+    void setSpeedMultiplier(qreal multiplier) { speedMultiplier = multiplier; }
+    void setOnGround(bool ground);
+
+    // 脚下的平台：落地时记录，离开地面时清空
+    // 只要还在平台的水平范围内、没有向上运动、脚底仍贴着平台顶部，
+    // 这个接触就一直有效，不需要每帧重新和平台做碰撞
+    EntityId getSupportPlatform() const { return supportPlatform; }
+    bool hasGroundContact() const;
+
+    // 玩家在注册表中的实体和所在的行
+    EntityId getEntityId() const { return id; }
+    int row() const { return registry.rowOf(id); }
+
+    // 变换和包围盒（左上角坐标）
+    QPointF pos() const { return players().position(row()); }
+    qreal x() const { return players().x[row()]; }
+    qreal y() const { return players().y[row()]; }
+    void setPos(qreal x, qreal y);
+    void setPos(const QPointF &position) { setPos(position.x(), position.y()); }
+    void setX(qreal x);
+    void setY(qreal y);
+    qreal width() const { return players().width[row()]; }
+    qreal height() const { return players().height[row()]; }
+    QRectF bounds() const { return players().bounds(row()); }
+
+    // 上一帧位置，由注册表在每帧开始时统一记录，用于扫掠检测和渲染插值
+    QPointF getPreviousPos() const { return players().previousPosition(row()); }
 
     // 新增方法
-    void equipArmor(Armor *newArmor);
-    Armor *getArmor() const { return armor; }
-    void setFacingRight(bool facing) { facingRight = facing; }
-    bool isOnGround() const { return onGround; }
-    bool hasWeapon() const { return weapon != nullptr; }
-
-    int getHealth() const { return health; }
+    void equipArmor(ArmorType type);
+    const Armor &getArmor() const { return players().armor[row()]; }
+    const Weapon &getWeapon() const { return players().weapon[row()]; }
+    bool hasArmor() const { return getArmor().getType() != ArmorType::NONE; }
+    void setFacingRight(bool facing);
+    bool isFacingRight() const { return players().hasFlag(row(), ENTITY_FACING_RIGHT); }
+    bool isOnGround() const { return players().hasFlag(row(), ENTITY_ON_GROUND); }
+    bool hasWeapon() const { return true; } // 武器槽里至少有拳头
+    bool isHidden() const { return players().hasFlag(row(), ENTITY_HIDDEN); }
+
+    int getHealth() const { return players().health[row()]; }
     int getPlayerID() const { return playerID; }
-    bool isCrouching() const { return crouching; }
+    QColor getColor() const { return color; }
+    bool isCrouching() const { return players().hasFlag(row(), ENTITY_CROUCHING); }
     QString getWeaponName() const;
     QString getArmorName() const;
 
     // 在Player类的public部分添加:
-    qreal getXVelocity() const { return xVelocity; }
-    qreal getYVelocity() const { return yVelocity; }
-    void setXVelocity(qreal velocity) { xVelocity = velocity; }
-    void setYVelocity(qreal velocity) { yVelocity = velocity; }
-
-    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
-    void setPlayerImage(const QString &imagePath);
+    qreal getXVelocity() const { return players().vx[row()]; }
+    qreal getYVelocity() const { return players().vy[row()]; }
+    void setXVelocity(qreal velocity);
+    void setYVelocity(qreal velocity);
 
 private:
+    EntityTable &players() { return registry.table(EntityKind::PLAYER); }
+    const EntityTable &players() const { return registry.table(EntityKind::PLAYER); }
+    void setFlag(EntityFlag flag, bool on);
+    void setHealth(int health);
+    Weapon &weapon() { return players().weapon[row()]; }
+    Armor &armor() { return players().armor[row()]; }
+
+    EntityRegistry &registry;
+    EntityId id;
     int playerID;
-    int health;
-    qreal xVelocity;
-    qreal yVelocity;
     qreal speed;
     qreal jumpForce;
-    bool onGround;
-    bool facingRight;
-    bool crouching;
-    bool hidden;
+    EntityId supportPlatform;
 
     QColor color;
-    Weapon *weapon;
-    Armor *armor; // 新增护甲
     PlatformType currentPlatform;
 
-    // 状态效果
-    bool hasAdrenaline;
-    QTimer *adrenalineTimer;
-    QTimer *adrenalineHealTimer;
+    qreal speedMultiplier;
 
     // 尺寸常量
     const qreal PLAYER_WIDTH = 40;
@@ -90,13 +116,6 @@ private:
     const qreal CROUCHING_HEIGHT = 40;
     const qreal GRAVITY = 0.5;
     const qreal ICE_SPEED_MULTIPLIER = 1.5;
-
-    QPixmap playerImage;
-    bool useImage;
-
-private slots:
-    void endAdrenalineEffect();
-    void adrenalineHeal();
 };
 
 #endif // PLAYER_H
@@ -0,0 +1,52 @@
+#ifndef PLAYERINPUT_H
+#define PLAYERINPUT_H
+
+#include <QtGlobal>
+
+// 玩家一帧的输入，按位组合；人类玩家由按键换算，AI由决策结果换算
+// 输入是“电平”语义：按住多少帧就在多少帧里置位
+enum PlayerInputBit : quint8 {
+    INPUT_LEFT       = 1 << 0,
+    INPUT_RIGHT      = 1 << 1,
+    INPUT_JUMP       = 1 << 2,
+    INPUT_CROUCH     = 1 << 3,
+    INPUT_FIRE       = 1 << 4,
+    INPUT_STOP       = 1 << 5, // 立即停止水平移动（AI使用，人类松开左右键时自动停止）
+    INPUT_FACE_LEFT  = 1 << 6, // 只转向不移动（AI瞄准时使用）
+    INPUT_FACE_RIGHT = 1 << 7
+};
+
+// 一帧中两名玩家的输入
+struct TickInput
+{
+    quint8 player[2] = {0, 0};
+
+    // 压缩成16位，便于录像存储
+    quint16 pack() const { return quint16(player[0] | (player[1] << 8)); }
+    static TickInput unpack(quint16 packed)
+    {
+        TickInput input;
+        input.player[0] = quint8(packed & 0xFF);
+        input.player[1] = quint8(packed >> 8);
+        return input;
+    }
+};
+
+// 把一名玩家的5个按键（左、右、跳、蹲、攻击）换算成输入位
+inline quint8 inputFromKeys(const bool *playerKeys)
+{
+    quint8 input = 0;
+    if (playerKeys[0])
+        input |= INPUT_LEFT;
+    if (playerKeys[1])
+        input |= INPUT_RIGHT;
+    if (playerKeys[2])
+        input |= INPUT_JUMP;
+    if (playerKeys[3])
+        input |= INPUT_CROUCH;
+    if (playerKeys[4])
+        input |= INPUT_FIRE;
+    return input;
+}
+
+#endif // PLAYERINPUT_H
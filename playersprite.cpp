@@ -0,0 +1,242 @@
+#include "playersprite.h"
+#include <QPainter>
+#include <QBrush>
+#include "assetmanager.h"
+
+PlayerSprite::PlayerSprite(const Player *player)
+    : player(player), useImage(false)
+{
+    setBrush(QBrush(player->getColor()));
+    sync();
+}
+
+void PlayerSprite::sync()
+{
+    // 下蹲时碰撞箱变矮，代理的矩形跟着变；setRect()会通知场景绘制范围变了
+    QRectF bounds = player->bounds();
+    if (rect().size() != bounds.size())
+        setRect(0, 0, bounds.width(), bounds.height());
+    setPos(bounds.topLeft());
+    setOpacity(player->isHidden() ? 0.3 : 1.0);
+
+    // 武器、护甲和朝向只影响绘制内容，每帧都可能变化
+    update();
+}
+
+void PlayerSprite::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+{
+    Q_UNUSED(option);
+    Q_UNUSED(widget);
+
+    // 在草地上下蹲时的半透明由sync()中的setOpacity()处理，这里不再设置
+    const Sprite &current = sprite();
+    painter->drawPixmap(current.offset, current.pixmap);
+}
+
+const Sprite &PlayerSprite::sprite() const
+{
+    return SpriteCache::instance().get(SpriteKind::PLAYER, spriteKey(), spriteBounds(),
+                                       [this](QPainter *target) { draw(target); });
+}
+
+QRectF PlayerSprite::boundingRect() const
+{
+    return QRectF(spriteBounds().toAlignedRect());
+}
+
+QRectF PlayerSprite::spriteBounds() const
+{
+    // 武器会伸出身体左右各37像素，狙击枪的瞄准镜在腰部以上15像素
+    return rect().adjusted(-40, -2, 40, 2);
+}
+
+quint32 PlayerSprite::spriteKey() const
+{
+    // 按位编码外观：玩家编号、朝向、下蹲、武器、护甲，防弹衣还要显示耐久度
+    const Armor &armor = player->getArmor();
+    int durability = armor.getType() == ArmorType::BULLETPROOF ? qBound(0, armor.getDurability(), 255) : 0;
+    quint32 key = quint32(player->getPlayerID()) & 0xF;
+    key |= (player->isFacingRight() ? 1u : 0u) << 4;
+    key |= (player->isCrouching() ? 1u : 0u) << 5;
+    key |= quint32(player->getWeapon().getType()) << 6;
+    key |= quint32(armor.getType()) << 9;
+    key |= quint32(durability) << 11;
+    key |= (useImage ? 1u : 0u) << 19;
+    // 不同的头像画出的外观不同，头像的缓存键也编进去，换头像时不必清空其他玩家的精灵
+    if (useImage)
+        key |= (quint32(qHash(playerImage.cacheKey())) & 0xFFF) << 20;
+    return key;
+}
+
+void PlayerSprite::draw(QPainter *painter) const
+{
+    const Armor *armor = player->hasArmor() ? &player->getArmor() : nullptr;
+    const Weapon *weapon = &player->getWeapon();
+    bool facingRight = player->isFacingRight();
+
+    // 绘制玩家主体
+    if (useImage && !playerImage.isNull())
+    {
+        // 绘制图片
+        painter->drawPixmap(rect().toRect(), playerImage);
+    }
+    else
+    {
+        // 绘制玩家矩形
+        painter->setBrush(player->getColor());
+        painter->drawRect(rect());
+    }
+
+    // 绘制面部方向指示器（眼睛）
+    painter->setBrush(Qt::white);
+    if (facingRight)
+    {
+        painter->drawEllipse(rect().width() - 15, 10, 10, 10);
+    }
+    else
+    {
+        painter->drawEllipse(5, 10, 10, 10);
+    }
+
+    // 绘制护甲（如果有）
+    if (armor)
+    {
+        QColor armorColor;
+        switch (armor->getType())
+        {
+        case ArmorType::LIGHT:
+            armorColor = QColor(150, 150, 255, 180); // 蓝色半透明
+            break;
+        case ArmorType::BULLETPROOF:
+            armorColor = QColor(50, 150, 50, 180); // 绿色半透明
+            break;
+        default:
+            armorColor = QColor(0, 0, 0, 0);
+        }
+
+        // 绘制护甲轮廓
+        painter->setBrush(QBrush(armorColor));
+        painter->setPen(QPen(Qt::black, 1));
+
+        // 根据玩家大小调整护甲尺寸
+        qreal armorPadding = 2;
+        QRectF armorRect = rect().adjusted(armorPadding, armorPadding,
+                                           -armorPadding, -armorPadding);
+        painter->drawRect(armorRect);
+
+        // 对于防弹衣，显示耐久度
+        if (armor->getType() == ArmorType::BULLETPROOF)
+        {
+            painter->setPen(Qt::white);
+            QFont font = painter->font();
+            font.setPointSize(6);
+            painter->setFont(font);
+            painter->drawText(armorRect, Qt::AlignTop | Qt::AlignHCenter,
+                              QString::number(armor->getDurability()));
+        }
+    }
+
+    // 绘制武器 - 增加武器尺寸和特征使其更明显
+    if (weapon)
+    {
+        QRectF weaponRect;
+        if (facingRight)
+        {
+            weaponRect = QRectF(rect().width() - 5, rect().height() / 2 - 5, 30, 10);
+        }
+        else
+        {
+            weaponRect = QRectF(-25, rect().height() / 2 - 5, 30, 10);
+        }
+
+        switch (weapon->getType())
+        {
+        case WeaponType::FIST:
+            painter->setBrush(QColor(200, 150, 100));
+            if (facingRight)
+            {
+                painter->drawEllipse(rect().width() - 10, rect().height() / 2 - 5, 15, 15);
+            }
+            else
+            {
+                painter->drawEllipse(-5, rect().height() / 2 - 5, 15, 15);
+            }
+            break;
+        case WeaponType::KNIFE:
+            painter->setBrush(QColor(150, 150, 150));
+            painter->drawRect(weaponRect);
+            // 添加刀刃
+            painter->setBrush(QColor(220, 220, 220));
+            if (facingRight)
+            {
+                painter->drawRect(rect().width() + 15, rect().height() / 2 - 5, 10, 10);
+            }
+            else
+            {
+                painter->drawRect(-25, rect().height() / 2 - 5, 10, 10);
+            }
+            break;
+        case WeaponType::BALL:
+            painter->setBrush(QColor(50, 50, 50));
+            if (facingRight)
+            {
+                painter->drawEllipse(rect().width(), rect().height() / 2 - 10, 20, 20);
+            }
+            else
+            {
+                painter->drawEllipse(-20, rect().height() / 2 - 10, 20, 20);
+            }
+            break;
+        case WeaponType::RIFLE:
+            painter->setBrush(QColor(100, 100, 100));
+            painter->drawRect(weaponRect);
+            // 添加枪口
+            painter->setBrush(QColor(70, 70, 70));
+            if (facingRight)
+            {
+                painter->drawRect(rect().width() + 25, rect().height() / 2 - 2, 8, 4);
+            }
+            else
+            {
+                painter->drawRect(-33, rect().height() / 2 - 2, 8, 4);
+            }
+            break;
+        case WeaponType::SNIPER:
+            painter->setBrush(QColor(70, 70, 70));
+            painter->drawRect(weaponRect);
+            // 添加狙击枪特征（枪口和瞄准镜）
+            painter->setBrush(QColor(50, 50, 50));
+            if (facingRight)
+            {
+                painter->drawRect(rect().width() + 25, rect().height() / 2 - 2, 12, 4);
+                painter->drawEllipse(rect().width() + 10, rect().height() / 2 - 15, 10, 10);
+            }
+            else
+            {
+                painter->drawRect(-37, rect().height() / 2 - 2, 12, 4);
+                painter->drawEllipse(-20, rect().height() / 2 - 15, 10, 10);
+            }
+            break;
+        }
+    }
+
+    // 绘制玩家ID
+    painter->setPen(Qt::white);
+    painter->drawText(rect().width() / 2 - 5, rect().height() - 10, QString::number(player->getPlayerID()));
+}
+void PlayerSprite::setPlayerImage(const QString &imagePath)
+{
+    playerImage = AssetManager::instance().pixmap(imagePath, PLAYER_IMAGE_SIZE);
+    if (!playerImage.isNull())
+    {
+        useImage = true;
+
+        // 暂时不改变矩形大小，保持原有游戏逻辑
+        // setRect(0, 0, playerImage.width(), playerImage.height());
+    }
+    else
+    {
+
+        useImage = false;
+    }
+}
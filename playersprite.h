@@ -0,0 +1,39 @@
+#ifndef PLAYERSPRITE_H
+#define PLAYERSPRITE_H
+
+#include <QGraphicsRectItem>
+#include <QPixmap>
+#include "player.h"
+#include "spritecache.h"
+
+// 玩家站立时的尺寸，头像预先缩放到这个大小
+const QSize PLAYER_IMAGE_SIZE(40, 80);
+
+// 玩家的渲染代理：读取Player的状态绘制玩家、朝向、护甲、武器和编号
+// 模拟不经过它，sync()在绘制前把位置、尺寸和隐身状态同步过来
+class PlayerSprite : public QGraphicsRectItem
+{
+public:
+    explicit PlayerSprite(const Player *player);
+
+    void sync();
+
+    // 每种外观（玩家×朝向×下蹲×武器×护甲×头像）只画一次，由精灵缓存保存
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
+    const Sprite &sprite() const;
+    // 包括伸出身体的武器，场景据此决定重绘哪些区域
+    QRectF boundingRect() const override;
+    // 头像由资源管理器加载，预加载过的不会再读磁盘
+    void setPlayerImage(const QString &imagePath);
+
+private:
+    QRectF spriteBounds() const;
+    quint32 spriteKey() const;
+    void draw(QPainter *painter) const;
+
+    const Player *player;
+    QPixmap playerImage;
+    bool useImage;
+};
+
+#endif // PLAYERSPRITE_H
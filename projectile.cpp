@@ -1,77 +1,59 @@
 #include "projectile.h"
 #include <QPainter>
 #include <QBrush>
-#include <cmath>
 
-Projectile::Projectile(qreal x, qreal y, bool facingRight, ProjectileType type, int damage, qreal speed, int ownerID, int lifespan)
-    : type(type), damage(damage), ownerID(ownerID), lifeTime(0), lifespan(lifespan)
+Projectile::Projectile(ProjectileType type, bool facingRight)
 {
-    // 设置投射物外观 - 增大尺寸使其更明显
-    switch (type) {
-    case ProjectileType::MELEE:
-        setRect(0, 0, 30, 10);
-        break;
-    case ProjectileType::BALL:
-        setRect(0, 0, 20, 20); // 增大实心球尺寸
-        break;
-    case ProjectileType::BULLET:
-        setRect(0, 0, 15, 7); // 增大子弹尺寸
-        break;
-    }
-
-    // 设置位置
-    setPos(x - rect().width()/2, y - rect().height()/2);
+    reset(type, facingRight);
+}
 
-    // 设置速度
-    if (type == ProjectileType::BALL) {
-        // 抛物线运动
-        xVelocity = facingRight ? speed : -speed;
-        yVelocity = -speed * 0.8; // 上抛
-    } else {
-        // 直线运动
-        xVelocity = facingRight ? speed : -speed;
-        yVelocity = 0;
-    }
+QSizeF Projectile::sizeFor(ProjectileType type)
+{
+    const ProjectileStats &stats = projectileStats(type);
+    return QSizeF(stats.width, stats.height);
 }
 
-void Projectile::move()
+void Projectile::reset(ProjectileType newType, bool newFacingRight)
 {
-    lifeTime++;
+    type = newType;
+    facingRight = newFacingRight;
 
-    // 检查生命周期
-    if (lifespan > 0 && lifeTime >= lifespan) {
-        // 标记为删除
-        setPos(-100, -100);
-        return;
-    }
+    // 清除上次使用时留下的插值变换
+    resetTransform();
 
-    // 保存当前位置
-    qreal oldX = x();
-    qreal oldY = y();
+    QSizeF size = sizeFor(type);
+    setRect(0, 0, size.width(), size.height());
+}
 
-    // 对于实心球，应用重力
-    if (type == ProjectileType::BALL) {
-        yVelocity += GRAVITY;
-    }
+void Projectile::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+{
+    Q_UNUSED(option);
+    Q_UNUSED(widget);
 
-    // 应用速度限制
-    const qreal MAX_PROJECTILE_SPEED = 20.0;
-    if (xVelocity > MAX_PROJECTILE_SPEED) xVelocity = MAX_PROJECTILE_SPEED;
-    if (xVelocity < -MAX_PROJECTILE_SPEED) xVelocity = -MAX_PROJECTILE_SPEED;
-    if (yVelocity > MAX_PROJECTILE_SPEED) yVelocity = MAX_PROJECTILE_SPEED;
-    if (yVelocity < -MAX_PROJECTILE_SPEED) yVelocity = -MAX_PROJECTILE_SPEED;
+    const Sprite &current = sprite();
+    painter->drawPixmap(current.offset, current.pixmap);
+}
 
-    // 移动投射物
-    setPos(x() + xVelocity, y() + yVelocity);
+const Sprite &Projectile::sprite() const
+{
+    quint32 key = quint32(type) * 2 + (facingRight ? 1 : 0);
+    return SpriteCache::instance().get(SpriteKind::PROJECTILE, key, spriteBounds(),
+                                       [this](QPainter *target) { draw(target); });
+}
 
-    // 边界检查在GameWindow中处理
+QRectF Projectile::boundingRect() const
+{
+    return QRectF(spriteBounds().toAlignedRect());
 }
 
-void Projectile::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+QRectF Projectile::spriteBounds() const
 {
-    Q_UNUSED(option);
-    Q_UNUSED(widget);
+    // 边框最宽2像素，会超出矩形1像素
+    return rect().adjusted(-1, -1, 1, 1);
+}
 
+void Projectile::draw(QPainter *painter) const
+{
     QColor color;
     QColor borderColor;
     qreal borderWidth = 0;
@@ -120,7 +102,7 @@ void Projectile::paint(QPainter *painter, const QStyleOptionGraphicsItem *option
         // 添加子弹头部特效
         QColor headColor(255, 255, 150); // 亮黄色子弹头
         painter->setBrush(headColor);
-        if (xVelocity > 0) {
+        if (facingRight) {
             // 向右飞行的子弹，头部在右侧
             QRectF headRect(rect().right() - 5, rect().top(), 5, rect().height());
             painter->drawRect(headRect);
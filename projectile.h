@@ -3,37 +3,36 @@
 
 #include <QGraphicsRectItem>
 #include <QColor>
+#include "gamedata.h"
+#include "spritecache.h"
 
-enum class ProjectileType {
-    MELEE,
-    BALL,
-    BULLET
-};
-
+// 投射物的渲染代理，只负责绘制
+// 位置、速度、伤害和寿命都在实体注册表的投射物表中，由ProjectilePool管理
 class Projectile : public QGraphicsRectItem
 {
 public:
-    Projectile(qreal x, qreal y, bool facingRight, ProjectileType type, int damage, qreal speed, int ownerID, int lifespan = -1);
+    Projectile(ProjectileType type, bool facingRight);
 
-    void move();
+    // 原地重置为另一个投射物的外观，供对象池复用
+    void reset(ProjectileType type, bool facingRight);
 
-    int getDamage() const { return damage; }
-    int getOwnerID() const { return ownerID; }
-    ProjectileType getType() const { return type; } // 确保有这个方法
+    // 各类投射物的碰撞箱尺寸
+    static QSizeF sizeFor(ProjectileType type);
 
+    ProjectileType getType() const { return type; }
+
+    // 每种投射物每个方向的外观只画一次，由精灵缓存保存
     void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
+    const Sprite &sprite() const;
+    // 覆盖精灵的整个绘制范围，场景据此决定重绘哪些区域
+    QRectF boundingRect() const override;
 
 private:
+    QRectF spriteBounds() const;
+    void draw(QPainter *painter) const;
+
     ProjectileType type;
-    int damage;
-    qreal xVelocity;
-    qreal yVelocity;
-    int ownerID;
-    int lifeTime;
-    int lifespan;
-
-    // 对于抛射物的重力
-    const qreal GRAVITY = 0.1;
+    bool facingRight;
 };
 
 #endif // PROJECTILE_H
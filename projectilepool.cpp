@@ -0,0 +1,201 @@
+#include "projectilepool.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PROJECTILE_POOL_SSE2
+#endif
+
+ProjectilePool::ProjectilePool(EntityRegistry &registry)
+    : registry(registry), renderProxies(false), highWaterMark(0), allocatedCount(0), acquireCount(0),
+      grownRowCount(0)
+{
+}
+
+ProjectilePool::~ProjectilePool()
+{
+    // 活动投射物的代理归注册表所有，这里只删除空闲的
+    qDeleteAll(freeList);
+}
+
+int ProjectilePool::acquire(qreal x, qreal y, bool facingRight, ProjectileType type,
+                            int damage, qreal speed, int ownerID, int lifespan)
+{
+    EntityId id = registry.create(EntityKind::PROJECTILE);
+    EntityTable &table = registry.table(EntityKind::PROJECTILE);
+    int row = registry.rowOf(id);
+
+    // 以发射点为中心放置
+    const ProjectileStats &stats = projectileStats(type);
+    table.x[row] = x - stats.width / 2;
+    table.y[row] = y - stats.height / 2;
+    table.prevX[row] = table.x[row];
+    table.prevY[row] = table.y[row];
+    table.width[row] = stats.width;
+    table.height[row] = stats.height;
+
+    // 实心球抛物线运动（上抛并受重力），其他直线运动
+    table.vx[row] = facingRight ? speed : -speed;
+    table.vy[row] = -speed * stats.lift;
+    table.gravity[row] = stats.gravity;
+
+    table.lifespan[row] = lifespan;
+    table.health[row] = damage;
+    table.owner[row] = ownerID;
+    table.subtype[row] = int(type);
+    table.setFlag(row, ENTITY_FACING_RIGHT, facingRight);
+
+    if (renderProxies)
+    {
+        Projectile *projectile;
+        if (!freeList.isEmpty())
+        {
+            projectile = freeList.takeLast();
+            projectile->reset(type, facingRight);
+            projectile->show();
+        }
+        else
+        {
+            projectile = new Projectile(type, facingRight);
+            allocatedCount++;
+        }
+        projectile->setPos(table.x[row], table.y[row]);
+        table.proxy[row] = projectile;
+    }
+
+    acquireCount++;
+    if (table.size() > highWaterMark)
+    {
+        grownRowCount++;
+        highWaterMark = table.size();
+    }
+    return row;
+}
+
+void ProjectilePool::release(int row)
+{
+    EntityTable &table = registry.table(EntityKind::PROJECTILE);
+
+    // 代理留给下一次发射，先从表中摘下，删除行时才不会被一起删掉
+    Projectile *projectile = static_cast<Projectile*>(table.proxy[row]);
+    if (projectile)
+    {
+        projectile->hide();
+        freeList.append(projectile);
+        table.proxy[row] = nullptr;
+    }
+    registry.destroyRow(EntityKind::PROJECTILE, row);
+}
+
+void ProjectilePool::releaseAll()
+{
+    while (size() > 0)
+    {
+        release(size() - 1);
+    }
+}
+
+void ProjectilePool::integrateScalar(EntityTable &table, int begin, int end, double dt)
+{
+    QVector<double> &posX = table.x;
+    QVector<double> &posY = table.y;
+    QVector<double> &velX = table.vx;
+    QVector<double> &velY = table.vy;
+    QVector<double> &lifeTime = table.age;
+    const QVector<double> &gravity = table.gravity;
+    const QVector<double> &lifespan = table.lifespan;
+
+    for (int i = begin; i < end; i++)
+    {
+        lifeTime[i] += dt;
+
+        // 到期的投射物不再移动，等待回收
+        if (lifespan[i] > 0 && lifeTime[i] >= lifespan[i])
+        {
+            table.setFlag(i, ENTITY_EXPIRED, true);
+            continue;
+        }
+
+        velY[i] += gravity[i] * dt;
+        velX[i] = qBound(-MAX_PROJECTILE_SPEED, velX[i], MAX_PROJECTILE_SPEED);
+        velY[i] = qBound(-MAX_PROJECTILE_SPEED, velY[i], MAX_PROJECTILE_SPEED);
+        posX[i] += velX[i] * dt;
+        posY[i] += velY[i] * dt;
+    }
+}
+
+void ProjectilePool::integrate(qreal step)
+{
+    const double dt = step;
+    EntityTable &table = registry.table(EntityKind::PROJECTILE);
+    const int count = table.size();
+    int i = 0;
+
+#ifdef PROJECTILE_POOL_SSE2
+    // 每次处理两个投射物；与标量版本做同样顺序的加法、乘法和比较，结果逐位相同
+    const __m128d vdt = _mm_set1_pd(dt);
+    const __m128d vzero = _mm_setzero_pd();
+    const __m128d vmax = _mm_set1_pd(MAX_PROJECTILE_SPEED);
+    const __m128d vmin = _mm_set1_pd(-MAX_PROJECTILE_SPEED);
+
+    QVector<double> &posX = table.x;
+    QVector<double> &posY = table.y;
+    QVector<double> &velX = table.vx;
+    QVector<double> &velY = table.vy;
+    QVector<double> &lifeTime = table.age;
+    const QVector<double> &gravity = table.gravity;
+    const QVector<double> &lifespan = table.lifespan;
+
+    for (; i + 2 <= count; i += 2)
+    {
+        __m128d life = _mm_add_pd(_mm_loadu_pd(lifeTime.constData() + i), vdt);
+        _mm_storeu_pd(lifeTime.data() + i, life);
+
+        // 到期：lifespan > 0 且 lifeTime >= lifespan
+        __m128d span = _mm_loadu_pd(lifespan.constData() + i);
+        __m128d dead = _mm_and_pd(_mm_cmpgt_pd(span, vzero), _mm_cmpge_pd(life, span));
+
+        __m128d oldVx = _mm_loadu_pd(velX.constData() + i);
+        __m128d oldVy = _mm_loadu_pd(velY.constData() + i);
+        __m128d oldX = _mm_loadu_pd(posX.constData() + i);
+        __m128d oldY = _mm_loadu_pd(posY.constData() + i);
+
+        __m128d vy = _mm_add_pd(oldVy, _mm_mul_pd(_mm_loadu_pd(gravity.constData() + i), vdt));
+        vy = _mm_min_pd(_mm_max_pd(vy, vmin), vmax);
+        __m128d vx = _mm_min_pd(_mm_max_pd(oldVx, vmin), vmax);
+        __m128d x = _mm_add_pd(oldX, _mm_mul_pd(vx, vdt));
+        __m128d y = _mm_add_pd(oldY, _mm_mul_pd(vy, vdt));
+
+        // 到期的保持原值
+        _mm_storeu_pd(velX.data() + i, _mm_or_pd(_mm_and_pd(dead, oldVx), _mm_andnot_pd(dead, vx)));
+        _mm_storeu_pd(velY.data() + i, _mm_or_pd(_mm_and_pd(dead, oldVy), _mm_andnot_pd(dead, vy)));
+        _mm_storeu_pd(posX.data() + i, _mm_or_pd(_mm_and_pd(dead, oldX), _mm_andnot_pd(dead, x)));
+        _mm_storeu_pd(posY.data() + i, _mm_or_pd(_mm_and_pd(dead, oldY), _mm_andnot_pd(dead, y)));
+
+        int mask = _mm_movemask_pd(dead);
+        if (mask & 1)
+            table.setFlag(i, ENTITY_EXPIRED, true);
+        if (mask & 2)
+            table.setFlag(i + 1, ENTITY_EXPIRED, true);
+    }
+#endif
+
+    // 剩余的（或不支持SSE2时全部）用标量处理
+    integrateScalar(table, i, count, dt);
+}
+
+void ProjectilePool::syncItems()
+{
+    const EntityTable &table = projectiles();
+    for (int i = 0; i < table.size(); i++)
+    {
+        if (table.proxy[i])
+            table.proxy[i]->setPos(table.x[i], table.y[i]);
+    }
+}
+
+double ProjectilePool::getReuseRate() const
+{
+    if (acquireCount == 0)
+        return 0.0;
+    return double(acquireCount - allocatedCount) / acquireCount;
+}
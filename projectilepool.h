@@ -0,0 +1,79 @@
+#ifndef PROJECTILEPOOL_H
+#define PROJECTILEPOOL_H
+
+#include <QVector>
+#include <QRectF>
+#include "entityregistry.h"
+#include "projectile.h"
+
+// 投射物的最大速度（像素/60Hz帧），重力等其他数值见PROJECTILE_STATS
+const double MAX_PROJECTILE_SPEED = 20.0;
+
+// 投射物系统：活动投射物的状态是实体注册表投射物表中的一行，
+// 位置、速度和寿命各占一列，每帧由integrate()在这些列上批量更新（支持SSE2时一次处理两个）
+// 删除时表的最后一行换到被删位置（交换后弹出），因此投射物的顺序不固定
+// 渲染代理（场景项）开启时才会创建；回收的代理放进空闲列表，下次发射时原地重置再用，
+// 避免每次开火都new、每次命中都delete。回收的代理只是隐藏，界面层加入场景后不需要再移除
+class ProjectilePool
+{
+public:
+    explicit ProjectilePool(EntityRegistry &registry);
+    ~ProjectilePool();
+
+    // 是否为投射物创建渲染代理，无界面模式下关闭
+    void setRenderProxies(bool enabled) { renderProxies = enabled; }
+
+    // 在投射物表末尾新增一个投射物，返回它所在的行
+    int acquire(qreal x, qreal y, bool facingRight, ProjectileType type,
+                int damage, qreal speed, int ownerID, int lifespan);
+
+    // 回收第row个投射物，原最后一行会移到row
+    void release(int row);
+
+    // 回收所有活动的投射物（新的一局开始时调用）
+    void releaseAll();
+
+    int size() const { return projectiles().size(); }
+    const EntityTable &projectiles() const { return registry.table(EntityKind::PROJECTILE); }
+
+    // 推进一帧：累计寿命、标记到期的投射物，未到期的施加重力、限速并移动
+    // dt为步长系数，寿命按60Hz帧数计算
+    void integrate(qreal dt);
+
+    // 第row个投射物的模拟状态
+    bool isExpired(int row) const { return projectiles().hasFlag(row, ENTITY_EXPIRED); }
+    QPointF position(int row) const { return projectiles().position(row); }
+    QPointF previousPosition(int row) const { return projectiles().previousPosition(row); }
+    QRectF bounds(int row) const { return projectiles().bounds(row); }
+    ProjectileType type(int row) const { return ProjectileType(projectiles().subtype[row]); }
+    int damage(int row) const { return projectiles().health[row]; }
+    int ownerID(int row) const { return projectiles().owner[row]; }
+    Projectile *proxy(int row) const { return static_cast<Projectile*>(projectiles().proxy[row]); }
+
+    // 把模拟状态同步到渲染代理的位置，只在需要绘制时调用
+    void syncItems();
+
+    // 统计：同时活动的最大数量、发射次数和需要扩充投射物表的次数
+    // 投射物表的列数组只增不减，其余的发射都复用已有的行，无界面模式下也有意义
+    int getHighWaterMark() const { return highWaterMark; }
+    qint64 getAcquireCount() const { return acquireCount; }
+    qint64 getGrownRowCount() const { return grownRowCount; }
+
+    // 渲染代理的统计：总共创建的代理数量和代理的复用比例，只在开启渲染代理时有意义
+    int getAllocatedCount() const { return allocatedCount; }
+    double getReuseRate() const;
+
+private:
+    void integrateScalar(EntityTable &table, int begin, int end, double dt);
+
+    EntityRegistry &registry;
+    QVector<Projectile*> freeList;
+    bool renderProxies;
+
+    int highWaterMark;
+    int allocatedCount;
+    qint64 acquireCount;
+    qint64 grownRowCount;
+};
+
+#endif // PROJECTILEPOOL_H
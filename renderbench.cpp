@@ -0,0 +1,503 @@
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QGraphicsScene>
+#include <QImage>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QPainter>
+#include <QRandomGenerator>
+#include <QStringList>
+#include <QStyleOptionGraphicsItem>
+#include <QTextStream>
+#include <QVector>
+#include <functional>
+#include "entityregistry.h"
+#include "player.h"
+#include "playersprite.h"
+#include "item.h"
+#include "projectile.h"
+#include "platform.h"
+#include "staticlayer.h"
+#include "hud.h"
+#include "spritecache.h"
+#include "assetmanager.h"
+
+// 一项测试在一种规模和分辨率下的测量结果
+struct RenderResult
+{
+    QString test;
+    int entities = 0;
+    QSize resolution;
+    qint64 iterations = 0;
+    double meanNs = 0;
+    double minNs = 0;
+};
+
+// 测试选项，所有测试共用
+struct RenderOptions
+{
+    qint64 minNs = 200000000;
+    quint32 seed = 1;
+    bool antialiasing = true;   // 与GameView一致
+    bool cold = false;          // 每次绘制前清空精灵缓存，测量真正的绘制代码
+};
+
+// 离屏渲染的场景：与GameWindow相同的静态层、渲染代理和信息栏，但不需要窗口和游戏世界
+// 玩家、物品和投射物随机散布在整个画面中，平台分布在下半部分，最底下是地面
+class RenderFixture
+{
+public:
+    RenderFixture(const QSize &resolution, int platformCount, quint32 seed)
+        : resolution(resolution), rng(seed),
+          scene(0, 0, resolution.width(), resolution.height())
+    {
+        // 背景和平台合成到静态层中，平台的渲染代理归注册表所有
+        addPlatform(0, resolution.height() - 50, resolution.width(), 50, PlatformType::GROUND);
+        while (registry.table(EntityKind::PLATFORM).size() < platformCount)
+        {
+            qreal width = 100 + 50 * rng.bounded(5);    // 常见的几种宽度，贴图按尺寸缓存
+            qreal x = rng.bounded(qMax(1, resolution.width() - int(width)));
+            qreal y = resolution.height() / 2 + rng.bounded(resolution.height() / 2 - 80);
+            addPlatform(x, y, width, 30, PlatformType(rng.bounded(3)));
+        }
+
+        staticLayer = new StaticLayer(resolution);
+        staticLayer->setZValue(-1000);
+        QPixmap background = AssetManager::instance().pixmap("./images/vs.jpeg", resolution,
+                                                             Qt::KeepAspectRatioByExpanding);
+        staticLayer->setBackground(background, 0.2, QColor(240, 240, 240));
+        staticLayer->rebuild(registry.table(EntityKind::PLATFORM));
+        scene.addItem(staticLayer);
+    }
+
+    ~RenderFixture()
+    {
+        // 场景删除自己的场景项；玩家代理引用着Player，必须先于Player删除
+        scene.clear();
+        qDeleteAll(players);
+    }
+
+    // 新增count个玩家，编号、朝向、下蹲、武器和护甲各不相同
+    // 只有前两个玩家使用头像，与游戏中一致
+    void addPlayers(int count)
+    {
+        static const ItemType WEAPONS[] = {ItemType::KNIFE, ItemType::BALL, ItemType::RIFLE, ItemType::SNIPER};
+        for (int i = 0; i < count; i++)
+        {
+            int index = players.size();
+            Player *player = new Player(registry, randomX(40), randomY(80),
+                                        index % 2 == 0 ? QColor(0, 0, 255) : QColor(255, 0, 0), index + 1);
+            if (index % 5 != 0)
+                player->pickupItem(WEAPONS[index % 4]);
+            if (index % 3 != 0)
+                player->equipArmor(index % 3 == 1 ? ArmorType::LIGHT : ArmorType::BULLETPROOF);
+            player->setFacingRight(index % 2 == 0);
+            player->crouch(index % 7 == 6);
+            players.append(player);
+
+            PlayerSprite *sprite = new PlayerSprite(player);
+            if (index < 2)
+                sprite->setPlayerImage(index == 0 ? "./images/chijing.jpeg" : "./images/anshi.jpeg");
+            playerSprites.append(sprite);
+            scene.addItem(sprite);
+        }
+    }
+
+    void addItems(int count)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            Item *item = new Item(ItemType(rng.bounded(ITEM_TYPE_COUNT)));
+            item->setPos(randomX(ITEM_SIZE), randomY(ITEM_SIZE));
+            items.append(item);
+            scene.addItem(item);
+        }
+    }
+
+    void addProjectiles(int count)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            Projectile *projectile = new Projectile(ProjectileType(rng.bounded(PROJECTILE_TYPE_COUNT)),
+                                                    rng.bounded(2) == 0);
+            projectile->setPos(randomX(20), randomY(20));
+            projectiles.append(projectile);
+            scene.addItem(projectile);
+        }
+    }
+
+    // 信息栏显示前两个玩家，需在addPlayers()之后调用
+    void addHud()
+    {
+        hud = new Hud(resolution.width());
+        hud->setZValue(1000);
+        hud->setPlayerNames("赤井秀一", "安室透");
+        hud->refresh(players.value(0), players.value(1));
+        scene.addItem(hud);
+    }
+
+    const EntityTable &platforms() const { return registry.table(EntityKind::PLATFORM); }
+
+    QSize resolution;
+    QRandomGenerator rng;
+    QGraphicsScene scene;
+    EntityRegistry registry;
+    StaticLayer *staticLayer = nullptr;
+    Hud *hud = nullptr;
+    QVector<Player *> players;
+    QVector<PlayerSprite *> playerSprites;
+    QVector<Item *> items;
+    QVector<Projectile *> projectiles;
+
+private:
+    void addPlatform(qreal x, qreal y, qreal width, qreal height, PlatformType type)
+    {
+        // 与SimWorld::addPlatform()相同，静态层按注册表中的平台合成
+        EntityId id = registry.create(EntityKind::PLATFORM);
+        EntityTable &table = registry.table(EntityKind::PLATFORM);
+        int row = registry.rowOf(id);
+        table.x[row] = x;
+        table.y[row] = y;
+        table.width[row] = width;
+        table.height[row] = height;
+        table.subtype[row] = int(type);
+        table.proxy[row] = new Platform(x, y, width, height, type);
+    }
+
+    qreal randomX(qreal width) { return rng.bounded(qMax(1, resolution.width() - int(width))); }
+    qreal randomY(qreal height) { return rng.bounded(qMax(1, resolution.height() - int(height))); }
+};
+
+// 离屏的绘制目标：与软件渲染的窗口后备缓冲相同的格式
+class RenderTarget
+{
+public:
+    RenderTarget(const QSize &size, bool antialiasing)
+        : image(size, QImage::Format_ARGB32_Premultiplied), antialiasing(antialiasing)
+    {
+        image.fill(Qt::white);
+    }
+
+    // 开始一帧：与视图一样先清空背景
+    void begin(QPainter &painter, bool clear)
+    {
+        if (clear)
+            image.fill(Qt::white);
+        painter.begin(&image);
+        painter.setRenderHint(QPainter::Antialiasing, antialiasing);
+    }
+
+    QImage image;
+    bool antialiasing;
+};
+
+// 反复运行run直到累计时间超过minNs（至少5次），reset在每次运行前执行，不计入时间
+static RenderResult measure(const QString &test, int entities, const QSize &resolution, qint64 minNs,
+                            const std::function<void()> &reset, const std::function<void()> &run)
+{
+    // 预热：加载贴图、画好精灵、建立场景索引
+    for (int i = 0; i < 3; i++)
+    {
+        reset();
+        run();
+    }
+
+    RenderResult result;
+    result.test = test;
+    result.entities = entities;
+    result.resolution = resolution;
+
+    QElapsedTimer timer;
+    qint64 total = 0;
+    qint64 fastest = -1;
+    while (total < minNs || result.iterations < 5)
+    {
+        reset();
+        timer.start();
+        run();
+        qint64 elapsed = timer.nsecsElapsed();
+        total += elapsed;
+        fastest = fastest < 0 ? elapsed : qMin(fastest, elapsed);
+        result.iterations++;
+    }
+
+    result.meanNs = double(total) / result.iterations;
+    result.minNs = double(fastest);
+    return result;
+}
+
+// 逐个调用场景项的paint()，变换和状态的保存恢复与QGraphicsScene绘制单个场景项时相同
+template <typename T>
+static void paintItems(QPainter &painter, const QVector<T *> &items)
+{
+    QStyleOptionGraphicsItem option;
+    for (T *item : items)
+    {
+        painter.save();
+        painter.translate(item->pos());
+        painter.setOpacity(item->effectiveOpacity());
+        option.exposedRect = item->boundingRect();
+        item->paint(&painter, &option, nullptr);
+        painter.restore();
+    }
+}
+
+// 单独测量一种场景项的paint()，entities个同种场景项画到一帧里
+// cold时每次绘制前调用clearCache清空对应的缓存
+template <typename T>
+static RenderResult benchPaint(const QString &test, const QSize &resolution, const RenderOptions &options,
+                               const QVector<T *> &items, const std::function<void()> &clearCache)
+{
+    RenderTarget target(resolution, options.antialiasing);
+    return measure(test, items.size(), resolution, options.minNs, [&]() {
+        if (options.cold)
+            clearCache();
+    }, [&]() {
+        QPainter painter;
+        target.begin(painter, false);
+        paintItems(painter, items);
+        painter.end();
+    });
+}
+
+static RenderResult benchPlayerPaint(int entities, const QSize &resolution, int platforms,
+                                     const RenderOptions &options)
+{
+    RenderFixture fixture(resolution, platforms, options.seed);
+    fixture.addPlayers(entities);
+    return benchPaint("paint_player", resolution, options, fixture.playerSprites,
+                      []() { SpriteCache::instance().clear(SpriteKind::PLAYER); });
+}
+
+static RenderResult benchItemPaint(int entities, const QSize &resolution, int platforms,
+                                   const RenderOptions &options)
+{
+    RenderFixture fixture(resolution, platforms, options.seed);
+    fixture.addItems(entities);
+    return benchPaint("paint_item", resolution, options, fixture.items,
+                      []() { SpriteCache::instance().clear(SpriteKind::ITEM); });
+}
+
+static RenderResult benchProjectilePaint(int entities, const QSize &resolution, int platforms,
+                                         const RenderOptions &options)
+{
+    RenderFixture fixture(resolution, platforms, options.seed);
+    fixture.addProjectiles(entities);
+    return benchPaint("paint_projectile", resolution, options, fixture.projectiles,
+                      []() { SpriteCache::instance().clear(SpriteKind::PROJECTILE); });
+}
+
+static RenderResult benchPlatformPaint(int entities, const QSize &resolution, int platforms,
+                                       const RenderOptions &options)
+{
+    // 平台平时只在合成静态层时绘制一次，这里测量的是换关卡时的开销
+    // 平台数量就是entities，贴图由资源管理器按尺寸缓存，没有精灵缓存
+    Q_UNUSED(platforms);
+    RenderFixture fixture(resolution, entities, options.seed);
+    QVector<Platform *> proxies;
+    const EntityTable &table = fixture.platforms();
+    for (int i = 0; i < table.size(); i++)
+        proxies.append(static_cast<Platform *>(table.proxy[i]));
+    return benchPaint("paint_platform", resolution, options, proxies, []() {});
+}
+
+static RenderResult benchFrame(int entities, const QSize &resolution, int platforms,
+                               const RenderOptions &options)
+{
+    // 一帧完整的游戏画面：静态层、两名玩家、物品和投射物各一半、信息栏
+    RenderFixture fixture(resolution, platforms, options.seed);
+    fixture.addPlayers(2);
+    fixture.addItems(entities / 2);
+    fixture.addProjectiles(entities - entities / 2);
+    fixture.addHud();
+
+    RenderTarget target(resolution, options.antialiasing);
+    QRectF rect(QPointF(0, 0), resolution);
+    return measure("frame", entities, resolution, options.minNs, [&]() {
+        if (options.cold)
+            SpriteCache::instance().clear();
+    }, [&]() {
+        QPainter painter;
+        target.begin(painter, true);
+        fixture.scene.render(&painter, rect, rect);
+        painter.end();
+    });
+}
+
+typedef RenderResult (*RenderTest)(int entities, const QSize &resolution, int platforms,
+                                   const RenderOptions &options);
+
+struct RenderEntry
+{
+    const char *name;
+    RenderTest test;
+};
+
+static const RenderEntry RENDER_TESTS[] = {
+    {"paint_player", benchPlayerPaint},
+    {"paint_item", benchItemPaint},
+    {"paint_projectile", benchProjectilePaint},
+    {"paint_platform", benchPlatformPaint},
+    {"frame", benchFrame},
+};
+
+static QVector<int> parseCounts(const QString &text)
+{
+    QVector<int> counts;
+    for (const QString &part : text.split(',', Qt::SkipEmptyParts))
+    {
+        int count = part.trimmed().toInt();
+        if (count > 0)
+            counts.append(count);
+    }
+    return counts;
+}
+
+// 分辨率写成“宽x高”，逗号分隔
+static QVector<QSize> parseResolutions(const QString &text)
+{
+    QVector<QSize> resolutions;
+    for (const QString &part : text.split(',', Qt::SkipEmptyParts))
+    {
+        QStringList size = part.trimmed().split('x');
+        if (size.size() != 2)
+            continue;
+        int width = size[0].toInt();
+        int height = size[1].toInt();
+        // 地面和平台需要一定的高度
+        if (width >= 200 && height >= 200)
+            resolutions.append(QSize(width, height));
+    }
+    return resolutions;
+}
+
+// 离屏渲染基准测试：用offscreen平台插件把场景画到QImage中，不需要显示器和GPU
+// 分别测量各种场景项的paint()和完整的一帧QGraphicsScene::render()，结果写成JSON
+// 贴图按相对路径加载，需要在images目录所在的目录下运行
+int main(int argc, char *argv[])
+{
+    // 没有指定平台插件时使用offscreen，在没有显示器的机器上也能运行
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication a(argc, argv);
+    QApplication::setApplicationName("HW1_1_renderbench");
+
+    // 图片和精灵缓存是函数内的静态对象，析构得比QApplication晚；这里没有事件循环，
+    // 不会发出aboutToQuit，在QApplication销毁前手动清空
+    struct CacheRelease
+    {
+        ~CacheRelease()
+        {
+            SpriteCache::instance().clear();
+            AssetManager::instance().clear();
+        }
+    } cacheRelease;
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("离屏渲染基准测试");
+    parser.addHelpOption();
+    QCommandLineOption entitiesOption("entities", "实体数量，逗号分隔", "list", "10,100,1000");
+    QCommandLineOption resolutionsOption("resolutions", "画面分辨率，逗号分隔", "list", "1200x800,1920x1080");
+    QCommandLineOption platformsOption("platforms", "整帧测试中的平台数量", "count", "20");
+    QCommandLineOption testsOption("tests", "只运行这些测试，逗号分隔（默认全部）", "list");
+    QCommandLineOption minTimeOption("min-time", "每种规模至少测量的时间（毫秒）", "ms", "200");
+    QCommandLineOption seedOption("seed", "场景的随机种子", "seed", "1");
+    QCommandLineOption coldOption("cold", "每次绘制前清空精灵缓存，测量精灵本身的绘制开销");
+    QCommandLineOption noAntialiasingOption("no-antialiasing", "关闭抗锯齿（游戏中默认开启）");
+    QCommandLineOption outputOption("output", "把JSON结果写到该文件（默认输出到标准输出）", "file");
+    parser.addOption(entitiesOption);
+    parser.addOption(resolutionsOption);
+    parser.addOption(platformsOption);
+    parser.addOption(testsOption);
+    parser.addOption(minTimeOption);
+    parser.addOption(seedOption);
+    parser.addOption(coldOption);
+    parser.addOption(noAntialiasingOption);
+    parser.addOption(outputOption);
+    parser.process(a);
+
+    QVector<int> entityCounts = parseCounts(parser.value(entitiesOption));
+    QVector<QSize> resolutions = parseResolutions(parser.value(resolutionsOption));
+    int platforms = qMax(1, parser.value(platformsOption).toInt());
+    QStringList tests = parser.value(testsOption).split(',', Qt::SkipEmptyParts);
+
+    RenderOptions options;
+    options.minNs = qint64(qMax(1, parser.value(minTimeOption).toInt())) * 1000000;
+    options.seed = parser.value(seedOption).toUInt();
+    options.cold = parser.isSet(coldOption);
+    options.antialiasing = !parser.isSet(noAntialiasingOption);
+
+    // 与游戏启动时一样先在工作线程上解码贴图
+    AssetManager &assets = AssetManager::instance();
+    assets.preload(Platform::texturePath(PlatformType::GROUND));
+    assets.preload(Platform::texturePath(PlatformType::GRASS));
+    assets.preload(Platform::texturePath(PlatformType::ICE));
+    assets.preload("./images/chijing.jpeg", PLAYER_IMAGE_SIZE);
+    assets.preload("./images/anshi.jpeg", PLAYER_IMAGE_SIZE);
+    assets.waitForPreload();
+
+    // 进度输出到标准错误，标准输出只留给JSON
+    QTextStream err(stderr);
+    QJsonArray results;
+    for (const RenderEntry &entry : RENDER_TESTS)
+    {
+        if (!tests.isEmpty() && !tests.contains(entry.name))
+            continue;
+        for (const QSize &resolution : resolutions)
+        {
+            for (int entities : entityCounts)
+            {
+                RenderResult result = entry.test(entities, resolution, platforms, options);
+                double perItem = result.meanNs / result.entities;
+                double fps = 1e9 / result.meanNs;
+                err << QString("%1 %2x%3 实体=%4: %5 us/帧, %6 ns/项, %7 FPS\n")
+                           .arg(result.test, -16).arg(resolution.width()).arg(resolution.height())
+                           .arg(result.entities).arg(result.meanNs / 1000, 0, 'f', 1)
+                           .arg(perItem, 0, 'f', 0).arg(fps, 0, 'f', 1);
+                err.flush();
+
+                QJsonObject json;
+                json.insert("test", result.test);
+                json.insert("entities", result.entities);
+                json.insert("width", resolution.width());
+                json.insert("height", resolution.height());
+                json.insert("iterations", result.iterations);
+                json.insert("mean_ns", result.meanNs);
+                json.insert("min_ns", result.minNs);
+                json.insert("ns_per_item", perItem);
+                json.insert("fps", fps);
+                results.append(json);
+            }
+        }
+    }
+
+    QJsonObject root;
+    root.insert("benchmark", "HW1_1_renderbench");
+    root.insert("platform", QGuiApplication::platformName());
+    root.insert("seed", qint64(options.seed));
+    root.insert("min_time_ms", options.minNs / 1000000);
+    root.insert("antialiasing", options.antialiasing);
+    root.insert("cold_sprites", options.cold);
+    root.insert("results", results);
+    QByteArray json = QJsonDocument(root).toJson(QJsonDocument::Indented);
+
+    if (parser.isSet(outputOption))
+    {
+        QFile file(parser.value(outputOption));
+        if (!file.open(QIODevice::WriteOnly) || file.write(json) < 0)
+        {
+            err << QString("无法写入%1: %2\n").arg(file.fileName(), file.errorString());
+            return 1;
+        }
+    }
+    else
+    {
+        QTextStream out(stdout);
+        out << json;
+    }
+    return 0;
+}
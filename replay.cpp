@@ -0,0 +1,175 @@
+#include "replay.h"
+#include <QFile>
+#include <QDataStream>
+
+// 文件头标识 "HWRP" 和格式版本
+static const quint32 REPLAY_MAGIC = 0x48575250;
+static const quint16 REPLAY_VERSION = 1;
+
+Replay::Replay()
+    : seed(0), tickRate(SIM_BASE_TICK_RATE), gameMode(GameMode::PLAYER_VS_PLAYER),
+      tickCount(0), winnerID(0), checksum(0), playRun(0), playOffset(0)
+{
+}
+
+void Replay::begin(quint32 newSeed, int newTickRate, GameMode mode)
+{
+    seed = newSeed;
+    tickRate = newTickRate;
+    gameMode = mode;
+    tickCount = 0;
+    winnerID = 0;
+    checksum = 0;
+    runs.clear();
+    rewind();
+}
+
+void Replay::append(const TickInput &input)
+{
+    quint16 packed = input.pack();
+    if (!runs.isEmpty() && runs.last().input == packed && runs.last().length < 0xFFFF)
+    {
+        runs.last().length++;
+    }
+    else
+    {
+        Run run;
+        run.input = packed;
+        run.length = 1;
+        runs.append(run);
+    }
+    tickCount++;
+}
+
+void Replay::setResult(int winner, quint32 finalChecksum)
+{
+    winnerID = winner;
+    checksum = finalChecksum;
+}
+
+void Replay::record(const SimWorld &world)
+{
+    append(world.getLastInput());
+    if (!world.isRunning())
+        setResult(world.getWinnerID(), world.stateChecksum());
+}
+
+bool Replay::save(const QString &path, QString *error) const
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        if (error)
+            *error = file.errorString();
+        return false;
+    }
+
+    QDataStream out(&file);
+    out.setByteOrder(QDataStream::LittleEndian);
+    out << REPLAY_MAGIC << REPLAY_VERSION
+        << seed << quint16(tickRate) << quint8(gameMode)
+        << quint32(tickCount) << quint8(winnerID) << checksum
+        << quint32(runs.size());
+    for (const Run &run : runs)
+    {
+        out << run.input << run.length;
+    }
+
+    if (out.status() != QDataStream::Ok)
+    {
+        if (error)
+            *error = "写入录像失败";
+        return false;
+    }
+    return true;
+}
+
+bool Replay::load(const QString &path, QString *error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        if (error)
+            *error = file.errorString();
+        return false;
+    }
+
+    QDataStream in(&file);
+    in.setByteOrder(QDataStream::LittleEndian);
+
+    quint32 magic = 0;
+    quint16 version = 0;
+    in >> magic >> version;
+    if (magic != REPLAY_MAGIC || version != REPLAY_VERSION)
+    {
+        if (error)
+            *error = "不是有效的录像文件";
+        return false;
+    }
+
+    // 先读到局部变量中，文件有效时才覆盖当前录像
+    quint32 fileSeed = 0;
+    quint16 fileTickRate = 0;
+    quint8 mode = 0;
+    quint32 ticks = 0;
+    quint8 winner = 0;
+    quint32 fileChecksum = 0;
+    quint32 runCount = 0;
+    in >> fileSeed >> fileTickRate >> mode >> ticks >> winner >> fileChecksum >> runCount;
+
+    // 每段占4字节，段数不可能超过文件剩余的长度；不信任文件中的计数，避免按它分配内存
+    bool valid = in.status() == QDataStream::Ok
+                 && mode <= quint8(GameMode::AI_VS_AI)
+                 && qint64(runCount) * 4 <= file.size() - file.pos();
+    QVector<Run> fileRuns;
+    qint64 total = 0;
+    if (valid)
+    {
+        fileRuns.reserve(int(runCount));
+        for (quint32 i = 0; i < runCount && in.status() == QDataStream::Ok; i++)
+        {
+            Run run;
+            in >> run.input >> run.length;
+            fileRuns.append(run);
+            total += run.length;
+        }
+    }
+
+    if (!valid || in.status() != QDataStream::Ok || total != ticks)
+    {
+        if (error)
+            *error = "录像文件已损坏";
+        return false;
+    }
+
+    seed = fileSeed;
+    tickRate = fileTickRate;
+    gameMode = GameMode(mode);
+    tickCount = ticks;
+    winnerID = winner;
+    checksum = fileChecksum;
+    runs = fileRuns;
+    rewind();
+    return true;
+}
+
+void Replay::rewind()
+{
+    playRun = 0;
+    playOffset = 0;
+}
+
+bool Replay::next(TickInput &input)
+{
+    if (playRun >= runs.size())
+        return false;
+
+    input = TickInput::unpack(runs[playRun].input);
+    playOffset++;
+    if (playOffset >= runs[playRun].length)
+    {
+        playRun++;
+        playOffset = 0;
+    }
+    return true;
+}
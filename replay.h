@@ -0,0 +1,64 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <QString>
+#include <QVector>
+#include "playerinput.h"
+#include "simworld.h"
+
+// 对局录像：只保存随机种子、帧率、模式和每帧的输入位
+// 输入按游程编码存储（相同输入连续多少帧），一整局通常只有几KB
+// 因为模拟是确定的，用同样的种子和输入回放即可完全重现对局
+class Replay
+{
+public:
+    Replay();
+
+    // 开始录制新的一局
+    void begin(quint32 seed, int tickRate, GameMode mode);
+
+    // 追加一帧输入
+    void append(const TickInput &input);
+
+    // 记录对局结果，回放时用来校验
+    void setResult(int winnerID, quint32 checksum);
+
+    // 在world.step()之后调用：追加这一帧实际执行的输入，对局在这一帧结束时同时记录结果
+    // gameOver信号在step()内部同步发出，所以不能在它的槽里保存录像，否则会少录最后一帧
+    void record(const SimWorld &world);
+
+    bool save(const QString &path, QString *error = nullptr) const;
+    bool load(const QString &path, QString *error = nullptr);
+
+    // 回放：从头开始逐帧取出输入，取完返回false
+    void rewind();
+    bool next(TickInput &input);
+
+    quint32 getSeed() const { return seed; }
+    int getTickRate() const { return tickRate; }
+    GameMode getGameMode() const { return gameMode; }
+    qint64 getTickCount() const { return tickCount; }
+    int getWinnerID() const { return winnerID; }
+    quint32 getChecksum() const { return checksum; }
+
+private:
+    struct Run
+    {
+        quint16 input;   // TickInput::pack()的结果
+        quint16 length;  // 连续帧数
+    };
+
+    quint32 seed;
+    int tickRate;
+    GameMode gameMode;
+    qint64 tickCount;
+    int winnerID;
+    quint32 checksum;
+    QVector<Run> runs;
+
+    // 回放位置
+    int playRun;
+    int playOffset;
+};
+
+#endif // REPLAY_H
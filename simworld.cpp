@@ -0,0 +1,680 @@
+#include "simworld.h"
+#include "ai.h"
+
+SimWorld::SimWorld(int width, int height, QObject *parent)
+    : QObject(parent), player1(nullptr), player2(nullptr), ai1(nullptr), ai2(nullptr),
+      projectiles(registry), renderProxies(false),
+      gameWidth(width), gameHeight(height), tickRate(SIM_BASE_TICK_RATE), stepScale(1.0),
+      tickCount(0), nextItemSpawnTime(SIM_ITEM_SPAWN_INTERVAL_MS), seed(0),
+      replayMode(false), running(false), winnerID(0),
+      gameMode(GameMode::PLAYER_VS_PLAYER), phaseTiming(false), phaseStart(0)
+{
+}
+
+SimWorld::~SimWorld()
+{
+    clear();
+}
+
+void SimWorld::clear()
+{
+    delete ai1;
+    delete ai2;
+    ai1 = nullptr;
+    ai2 = nullptr;
+
+    // 投射物的渲染代理只回收不删除，下一局继续复用
+    projectiles.releaseAll();
+    effects.clear();
+
+    delete player1;
+    delete player2;
+    player1 = nullptr;
+    player2 = nullptr;
+
+    // 删除剩下的物品和平台，连同它们的渲染代理
+    platformGrid.clear();
+    registry.clear();
+}
+
+void SimWorld::reset(GameMode mode, quint32 newSeed)
+{
+    clear();
+    gameMode = mode;
+    seed = newSeed;
+    rng.seed(seed);
+
+    // 重置输入状态
+    lastInput = TickInput();
+    aiActions[0] = 0;
+    aiActions[1] = 0;
+
+    // 创建游戏元素
+    createPlayers();
+    createPlatforms();
+
+    // 创建AI控制器，AI的种子总是从世界的随机数流中取出，
+    // 这样不论哪种模式，后续的物品生成序列都只取决于世界种子
+    quint32 ai1Seed = rng.generate();
+    quint32 ai2Seed = rng.generate();
+    if (gameMode != GameMode::PLAYER_VS_PLAYER)
+    {
+        ai2 = new AI(player2, ai2Seed);
+    }
+    if (gameMode == GameMode::AI_VS_AI)
+    {
+        ai1 = new AI(player1, ai1Seed);
+    }
+
+    running = true;
+    winnerID = 0;
+    tickCount = 0;
+    nextItemSpawnTime = SIM_ITEM_SPAWN_INTERVAL_MS;
+}
+
+void SimWorld::setTickRate(int hz)
+{
+    tickRate = roundTickRate(hz);
+    stepScale = qreal(SIM_BASE_TICK_RATE) / tickRate;
+    effects.setTickRate(tickRate);
+}
+
+void SimWorld::setRenderProxies(bool enabled)
+{
+    renderProxies = enabled;
+    projectiles.setRenderProxies(enabled);
+}
+
+void SimWorld::setPhaseTiming(bool enabled)
+{
+    phaseTiming = enabled;
+    resetPhaseTiming();
+}
+
+void SimWorld::resetPhaseTiming()
+{
+    for (int i = 0; i < SIM_PHASE_COUNT; i++)
+    {
+        phaseNanos[i] = 0;
+    }
+    phaseClock.start();
+    phaseStart = 0;
+}
+
+const char *SimWorld::phaseName(int phase)
+{
+    switch (phase)
+    {
+    case SIM_PHASE_INPUT:
+        return "input";
+    case SIM_PHASE_AI:
+        return "ai";
+    case SIM_PHASE_PLAYERS:
+        return "players";
+    case SIM_PHASE_ITEMS:
+        return "items";
+    case SIM_PHASE_PROJECTILES:
+        return "projectiles";
+    case SIM_PHASE_COLLISIONS:
+        return "collisions";
+    default:
+        return "unknown";
+    }
+}
+
+void SimWorld::endPhase(SimPhase phase)
+{
+    if (!phaseTiming)
+        return;
+
+    // 把从上一个阶段结束到现在的时间记到本阶段
+    qint64 now = phaseClock.nsecsElapsed();
+    phaseNanos[phase] += now - phaseStart;
+    phaseStart = now;
+}
+
+void SimWorld::createPlayers()
+{
+    // 创建玩家1 - 放在左侧草地平台上
+    player1 = new Player(registry, 250, gameHeight - 260, QColor(0, 0, 255), 1);
+
+    // 创建玩家2 - 放在右侧冰面平台上
+    player2 = new Player(registry, 850, gameHeight - 260, QColor(255, 0, 0), 2);
+
+    if (renderProxies)
+    {
+        EntityTable &players = registry.table(EntityKind::PLAYER);
+        players.proxy[player1->row()] = new PlayerSprite(player1);
+        players.proxy[player2->row()] = new PlayerSprite(player2);
+    }
+}
+
+void SimWorld::createPlatforms()
+{
+    // 创建地面
+    addPlatform(0, gameHeight - 50, gameWidth, 50, PlatformType::GROUND);
+
+    // 创建草地平台（二层平台）
+    addPlatform(200, gameHeight - 200, 300, 30, PlatformType::GRASS);
+
+    // 创建冰面平台（二层平台）
+    addPlatform(700, gameHeight - 200, 300, 30, PlatformType::ICE);
+
+    // 创建高层平台（三层平台）
+    addPlatform(150, gameHeight - 350, 200, 30, PlatformType::GROUND);
+    addPlatform(850, gameHeight - 350, 200, 30, PlatformType::GROUND);
+
+    // 创建中间平台（三层平台）
+    addPlatform(gameWidth / 2 - 150, gameHeight - 500, 300, 30, PlatformType::GROUND);
+
+    // 平台不会移动，建一次网格即可
+    platformGrid.build(registry.table(EntityKind::PLATFORM), QRectF(0, 0, gameWidth, gameHeight));
+}
+
+void SimWorld::addPlatform(qreal x, qreal y, qreal width, qreal height, PlatformType type)
+{
+    EntityId id = registry.create(EntityKind::PLATFORM);
+    EntityTable &platforms = registry.table(EntityKind::PLATFORM);
+    int row = registry.rowOf(id);
+    platforms.x[row] = x;
+    platforms.y[row] = y;
+    platforms.prevX[row] = x;
+    platforms.prevY[row] = y;
+    platforms.width[row] = width;
+    platforms.height[row] = height;
+    platforms.subtype[row] = int(type);
+
+    // 平台的渲染代理由界面合成到静态层中，不会逐帧绘制
+    if (renderProxies)
+        platforms.proxy[row] = new Platform(x, y, width, height, type);
+}
+
+void SimWorld::spawnItem()
+{
+    // 按ITEM_STATS中的生成权重随机选择物品类型
+    int roll = rng.bounded(itemSpawnWeightTotal());
+    ItemType type = ItemType::BULLETPROOF_VEST;
+    for (const ItemStats &stats : ITEM_STATS)
+    {
+        roll -= stats.spawnWeight;
+        if (roll < 0)
+        {
+            type = stats.type;
+            break;
+        }
+    }
+
+    // 在随机位置生成物品
+    int x = rng.bounded(100, gameWidth - 100);
+    EntityId id = registry.create(EntityKind::ITEM);
+    EntityTable &items = registry.table(EntityKind::ITEM);
+    int row = registry.rowOf(id);
+    items.x[row] = x;
+    items.prevX[row] = x;
+    items.width[row] = ITEM_SIZE;
+    items.height[row] = ITEM_SIZE;
+    items.gravity[row] = ITEM_GRAVITY;
+    items.subtype[row] = int(type);
+    items.age[row] = tickCount; // 物品用age记录生成时的帧号，数量超限时删除最早的
+
+    if (renderProxies)
+    {
+        Item *item = new Item(type);
+        item->setPos(x, 0);
+        items.proxy[row] = item;
+        emit itemSpawned(item);
+    }
+}
+
+void SimWorld::spawnItems()
+{
+    spawnItem();
+
+    // 限制物品数量，防止过多；删除时行会被交换，所以按生成时间找最早的
+    const EntityTable &items = registry.table(EntityKind::ITEM);
+    if (items.size() > 15)
+    {
+        int oldest = 0;
+        for (int i = 1; i < items.size(); i++)
+        {
+            if (items.age[i] < items.age[oldest])
+                oldest = i;
+        }
+        registry.destroyRow(EntityKind::ITEM, oldest);
+    }
+}
+
+void SimWorld::applyInput(Player *player, quint8 input, quint8 previousInput, qint64 nowMs)
+{
+    // 松开左右键时立即停止水平移动
+    quint8 released = previousInput & ~input;
+    if ((input & INPUT_STOP) || (released & (INPUT_LEFT | INPUT_RIGHT)))
+        player->stopMoving();
+
+    // 只转向不移动
+    if (input & INPUT_FACE_LEFT)
+        player->setFacingRight(false);
+    if (input & INPUT_FACE_RIGHT)
+        player->setFacingRight(true);
+
+    if (input & INPUT_LEFT)
+        player->moveLeft();
+    if (input & INPUT_RIGHT)
+        player->moveRight();
+    if (input & INPUT_JUMP)
+        player->jump();
+    if (input & INPUT_CROUCH)
+        player->crouch(true);
+    else
+        player->crouch(false);
+    if (input & INPUT_FIRE)
+        player->fire(projectiles, nowMs);
+}
+
+void SimWorld::step(const TickInput &input)
+{
+    if (!running)
+        return;
+
+    if (phaseTiming)
+        phaseStart = phaseClock.nsecsElapsed();
+
+    // 记录所有实体上一帧的位置，供扫掠检测和渲染插值使用
+    registry.savePreviousPositions();
+
+    int firstNewProjectile = projectiles.size();
+
+    // AI的计时器按60Hz帧计数，高帧率下只在对应的帧上思考，
+    // 两次思考之间保持上一次的决定
+    int ticksPerBaseFrame = tickRate / SIM_BASE_TICK_RATE;
+    bool aiThinks = (tickCount % ticksPerBaseFrame) == 0;
+    tickCount++;
+    qint64 nowMs = getTimeMs();
+
+    // 定时生成物品
+    if (nowMs >= nextItemSpawnTime)
+    {
+        spawnItems();
+        nextItemSpawnTime += SIM_ITEM_SPAWN_INTERVAL_MS;
+    }
+    endPhase(SIM_PHASE_INPUT);
+
+    // 确定本帧两名玩家的输入：回放时完全使用录像中的输入，否则AI控制的玩家由AI决定
+    TickInput applied = input;
+    if (!replayMode)
+    {
+        if (ai1)
+        {
+            if (aiThinks)
+                aiActions[0] = ai1->update(player2, registry);
+            applied.player[0] = aiActions[0];
+        }
+        if (ai2)
+        {
+            if (aiThinks)
+                aiActions[1] = ai2->update(player1, registry);
+            applied.player[1] = aiActions[1];
+        }
+    }
+    endPhase(SIM_PHASE_AI);
+
+    applyInput(player1, applied.player[0], lastInput.player[0], nowMs);
+    applyInput(player2, applied.player[1], lastInput.player[1], nowMs);
+    lastInput = applied;
+
+    // 通知界面层新发射的投射物
+    for (int i = firstNewProjectile; i < projectiles.size(); i++)
+    {
+        if (Projectile *proxy = projectiles.proxy(i))
+            emit projectileSpawned(proxy);
+    }
+    endPhase(SIM_PHASE_INPUT);
+
+    // 应用重力和移动
+    player1->applyGravity(stepScale);
+    player2->applyGravity(stepScale);
+
+    player1->move(stepScale);
+    player2->move(stepScale);
+
+    // 状态效果按帧计时：周期回血、到期移除，再把速度倍率同步给玩家
+    effects.update(tickCount, registry);
+    player1->setSpeedMultiplier(effects.speedMultiplier(player1->getEntityId()));
+    player2->setSpeedMultiplier(effects.speedMultiplier(player2->getEntityId()));
+
+    player1->updateEquipment();
+    player2->updateEquipment();
+
+    // 检查玩家与平台的碰撞，只检查网格中附近的平台
+    collidePlayerWithPlatforms(player1);
+    collidePlayerWithPlatforms(player2);
+    endPhase(SIM_PHASE_PLAYERS);
+
+    // 更新物品的下落和着陆
+    updateItems();
+    endPhase(SIM_PHASE_ITEMS);
+
+    // 更新投射物：在投射物表的连续列上批量积分
+    projectiles.integrate(stepScale);
+
+    // 超过寿命的投射物直接回收；出界检查放在命中判定之后，
+    // 这样飞出场地前在路径上击中的目标仍然有效
+    // 回收时最后一个投射物会换到当前位置，所以回收后不前进
+    for (int i = 0; i < projectiles.size();)
+    {
+        if (projectiles.isExpired(i))
+        {
+            projectiles.release(i);
+            continue;
+        }
+        i++;
+    }
+    endPhase(SIM_PHASE_PROJECTILES);
+
+    // 检查物品拾取和其他碰撞
+    checkCollisions();
+    if (!running)
+    {
+        endPhase(SIM_PHASE_COLLISIONS);
+        return;
+    }
+
+    // 检查护甲和弹药
+    player1->updateEquipment();
+    player2->updateEquipment();
+    endPhase(SIM_PHASE_COLLISIONS);
+}
+
+void SimWorld::collidePlayerWithPlatforms(Player *player)
+{
+    const EntityTable &platforms = registry.table(EntityKind::PLATFORM);
+
+    // 站在平台上的玩家沿用上一帧的接触，不需要搜索；
+    // 水平移动时只确认身体没有撞上别的平台（例如墙壁），脚下的一排不算
+    if (player->hasGroundContact())
+    {
+        if (player->x() == player->getPreviousPos().x())
+            return;
+
+        QRectF body = player->bounds();
+        body.setBottom(body.bottom() - 1);
+        platformGrid.query(body, nearbyPlatforms);
+        if (nearbyPlatforms.isEmpty())
+            return;
+    }
+
+    // 接触失效，重置地面状态后完整检测一次
+    player->setOnGround(false);
+
+    // 查询范围覆盖本帧的整个移动路径，碰撞修正只会把玩家推回路径上
+    QRectF endRect = player->bounds();
+    QPointF displacement = player->pos() - player->getPreviousPos();
+    QRectF startRect = endRect.translated(-displacement);
+    platformGrid.query(endRect.united(startRect), nearbyPlatforms);
+
+    // 沿移动路径找最早碰到的平台；如果终点已经穿过了它（终点不重叠），
+    // 先退回到接触位置，再交给下面的常规碰撞处理
+    SweepHit earliest;
+    int firstHit = -1;
+    for (int platform : nearbyPlatforms)
+    {
+        SweepHit hit = sweepAABB(startRect, displacement, platforms.bounds(platform));
+        if (hit.hit && hit.time > 0 && hit.time < earliest.time)
+        {
+            earliest = hit;
+            firstHit = platform;
+        }
+    }
+    if (firstHit >= 0 && !aabbOverlap(endRect, platforms.bounds(firstHit)))
+    {
+        player->setPos(player->getPreviousPos() + displacement * earliest.time);
+    }
+
+    for (int platform : nearbyPlatforms)
+    {
+        player->checkPlatformCollision(platforms, platform, stepScale);
+    }
+}
+
+void SimWorld::updateItems()
+{
+    EntityTable &items = registry.table(EntityKind::ITEM);
+    const EntityTable &platforms = registry.table(EntityKind::PLATFORM);
+
+    // 每个物品每帧只积分一次；已经落地的物品在休眠，直接跳过
+    for (int i = 0; i < items.size(); i++)
+    {
+        if (items.hasFlag(i, ENTITY_ON_GROUND))
+            continue;
+
+        items.vy[i] += items.gravity[i] * stepScale;
+        items.y[i] += items.vy[i] * stepScale;
+
+        // 查询范围覆盖本帧的下落路径
+        QRectF itemRect = items.bounds(i);
+        QRectF path = itemRect;
+        path.setTop(path.top() - items.vy[i] * stepScale);
+        platformGrid.query(path, nearbyPlatforms);
+
+        for (int platform : nearbyPlatforms)
+        {
+            // 只处理从上方着陆
+            QRectF platformRect = platforms.bounds(platform);
+            if (registry.collide(EntityKind::ITEM, i, EntityKind::PLATFORM, platform) &&
+                itemRect.bottom() >= platformRect.top() &&
+                itemRect.bottom() - items.vy[i] * stepScale <= platformRect.top())
+            {
+                // 着陆在平台上，进入休眠
+                items.y[i] = platformRect.top() - items.height[i];
+                items.vy[i] = 0;
+                items.setFlag(i, ENTITY_ON_GROUND, true);
+                break;
+            }
+        }
+    }
+}
+
+void SimWorld::checkCollisions()
+{
+    // 检查玩家与物品碰撞（拾取）
+    // 删除时最后一个物品会换到当前位置，所以删除后不前进
+    Player *players[2] = {player1, player2};
+    const EntityTable &items = registry.table(EntityKind::ITEM);
+    for (int i = 0; i < items.size();)
+    {
+        // 只有在下蹲状态且与物品碰撞时才拾取
+        Player *picker = nullptr;
+        for (Player *player : players)
+        {
+            if (player->isCrouching() &&
+                registry.collide(EntityKind::PLAYER, player->row(), EntityKind::ITEM, i))
+            {
+                picker = player;
+                break;
+            }
+        }
+
+        if (picker)
+        {
+            ItemType type = ItemType(items.subtype[i]);
+            picker->pickupItem(type);
+
+            StatusEffectType effect = itemStats(type).effect;
+            if (effect != StatusEffectType::NONE)
+            {
+                effects.apply(picker->getEntityId(), effect, tickCount);
+                picker->setSpeedMultiplier(effects.speedMultiplier(picker->getEntityId()));
+            }
+            registry.destroyRow(EntityKind::ITEM, i);
+            continue;
+        }
+        i++;
+    }
+
+    // 检查投射物与玩家、平台的碰撞
+    // 沿本帧的移动路径做扫掠检测，取最早接触的目标，快速的子弹也不会穿过薄平台
+    // 回收时最后一个投射物会换到当前位置，所以回收后不前进
+    const EntityTable &platforms = registry.table(EntityKind::PLATFORM);
+    for (int i = 0; i < projectiles.size();)
+    {
+        ProjectileType type = projectiles.type(i);
+
+        // 排除自己发射的投射物；同时接触时与原来一样先判定玩家1
+        SweepHit earliest;
+        Player *target = nullptr;
+        for (Player *player : players)
+        {
+            if (projectiles.ownerID(i) == player->getPlayerID())
+                continue;
+            SweepHit hit = sweepProjectile(i, player);
+            if (hit.hit && (!target || hit.time < earliest.time))
+            {
+                earliest = hit;
+                target = player;
+            }
+        }
+
+        // 只有子弹和球才会与平台碰撞消失，比玩家更早碰到平台时被平台挡住
+        if (projectileStats(type).hitsPlatforms)
+        {
+            QPointF displacement = projectiles.position(i) - projectiles.previousPosition(i);
+            QRectF endRect = projectiles.bounds(i);
+            QRectF startRect = endRect.translated(-displacement);
+            platformGrid.query(endRect.united(startRect), nearbyPlatforms);
+            for (int platform : nearbyPlatforms)
+            {
+                SweepHit hit = sweepAABB(startRect, displacement, platforms.bounds(platform));
+                if (hit.hit && (!target || hit.time < earliest.time))
+                {
+                    target = nullptr;
+                    earliest = hit;
+                }
+            }
+        }
+
+        if (target)
+        {
+            target->takeDamage(projectiles.damage(i), type);
+            projectiles.release(i);
+
+            // 检查被击中的玩家是否已死亡
+            if (target->getHealth() <= 0)
+            {
+                finish(target == player1 ? player2 : player1);
+                return;
+            }
+            continue;
+        }
+
+        if (earliest.hit)
+        {
+            projectiles.release(i);
+            continue;
+        }
+
+        // 检查投射物边界
+        QPointF position = projectiles.position(i);
+        if (position.x() < 0 || position.x() > gameWidth ||
+            position.y() < 0 || position.y() > gameHeight)
+        {
+            projectiles.release(i);
+            continue;
+        }
+        i++;
+    }
+}
+
+SweepHit SimWorld::sweepProjectile(int row, Player *player) const
+{
+    // 用相对位移检测两个都在移动的盒子：把玩家看作静止在上一帧的位置
+    QPointF projectileMove = projectiles.position(row) - projectiles.previousPosition(row);
+    QPointF playerMove = player->pos() - player->getPreviousPos();
+    QRectF projectileStart = projectiles.bounds(row).translated(-projectileMove);
+    QRectF playerStart = player->bounds().translated(-playerMove);
+    return sweepAABB(projectileStart, projectileMove - playerMove, playerStart);
+}
+
+void SimWorld::finish(Player *winner)
+{
+    running = false;
+    winnerID = winner->getPlayerID();
+    emit gameOver(winnerID);
+}
+
+// FNV-1a哈希，用于计算状态校验值
+static quint32 hashBytes(quint32 hash, const void *data, int size)
+{
+    const uchar *bytes = static_cast<const uchar *>(data);
+    for (int i = 0; i < size; i++)
+    {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static quint32 hashReal(quint32 hash, qreal value)
+{
+    return hashBytes(hash, &value, sizeof(value));
+}
+
+quint32 SimWorld::stateChecksum() const
+{
+    quint32 hash = 2166136261u;
+    hash = hashBytes(hash, &tickCount, sizeof(tickCount));
+
+    Player *players[2] = {player1, player2};
+    for (Player *player : players)
+    {
+        if (!player)
+            continue;
+        int health = player->getHealth();
+        hash = hashBytes(hash, &health, sizeof(health));
+        hash = hashReal(hash, player->x());
+        hash = hashReal(hash, player->y());
+        hash = hashReal(hash, player->getXVelocity());
+        hash = hashReal(hash, player->getYVelocity());
+    }
+
+    const EntityTable &items = registry.table(EntityKind::ITEM);
+    for (int i = 0; i < items.size(); i++)
+    {
+        hash = hashReal(hash, items.x[i]);
+        hash = hashReal(hash, items.y[i]);
+    }
+
+    for (int i = 0; i < projectiles.size(); i++)
+    {
+        QPointF position = projectiles.position(i);
+        hash = hashReal(hash, position.x());
+        hash = hashReal(hash, position.y());
+    }
+
+    return hash;
+}
+
+PlayerSprite *SimWorld::getPlayerSprite(const Player *player) const
+{
+    return static_cast<PlayerSprite*>(registry.table(EntityKind::PLAYER).proxy[player->row()]);
+}
+
+void SimWorld::syncRenderProxies()
+{
+    if (!renderProxies)
+        return;
+
+    const EntityTable &players = registry.table(EntityKind::PLAYER);
+    for (int i = 0; i < players.size(); i++)
+    {
+        static_cast<PlayerSprite*>(players.proxy[i])->sync();
+    }
+
+    // 平台不会移动，不需要同步
+    const EntityTable &items = registry.table(EntityKind::ITEM);
+    for (int i = 0; i < items.size(); i++)
+    {
+        items.proxy[i]->setPos(items.x[i], items.y[i]);
+    }
+
+    projectiles.syncItems();
+}
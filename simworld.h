@@ -0,0 +1,169 @@
+#ifndef SIMWORLD_H
+#define SIMWORLD_H
+
+#include <QObject>
+#include <QList>
+#include <QRandomGenerator>
+#include <QElapsedTimer>
+#include "entityregistry.h"
+#include "player.h"
+#include "playersprite.h"
+#include "platform.h"
+#include "item.h"
+#include "projectilepool.h"
+#include "platformgrid.h"
+#include "statuseffects.h"
+#include "sweptaabb.h"
+#include "playerinput.h"
+#include "tickrate.h"
+
+class AI;
+
+// 游戏模式枚举
+enum class GameMode {
+    PLAYER_VS_PLAYER,
+    PLAYER_VS_AI,
+    AI_VS_AI        // 无界面模式下的AI互搏
+};
+
+// 按键数量：每名玩家5个键（左、右、跳、蹲、攻击）
+const int SIM_KEY_COUNT = 10;
+
+// 物品生成间隔（模拟时间，毫秒）
+const int SIM_ITEM_SPAWN_INTERVAL_MS = 5000;
+
+// step()内部的各个阶段，用于统计每个阶段的耗时
+enum SimPhase {
+    SIM_PHASE_INPUT,        // 物品生成和执行输入
+    SIM_PHASE_AI,           // AI决策
+    SIM_PHASE_PLAYERS,      // 玩家的重力、移动、状态效果、装备检查和平台碰撞
+    SIM_PHASE_ITEMS,        // 物品的下落和着陆
+    SIM_PHASE_PROJECTILES,  // 投射物移动和出界检查
+    SIM_PHASE_COLLISIONS,   // 拾取和命中判定
+    SIM_PHASE_COUNT
+};
+
+// 纯逻辑的游戏世界，不依赖任何窗口、场景或标签
+// 玩家、平台、物品和投射物的状态都在实体注册表的各张表中，每次调用step()推进一帧，
+// 各个系统按行线性遍历这些表；场景项只是可选的渲染代理
+// 所有计时都来自帧计数，所有随机数都来自按种子初始化的独立随机数流，
+// 因此同一种子和同样的输入总会得到同样的对局
+class SimWorld : public QObject
+{
+    Q_OBJECT
+
+public:
+    SimWorld(int width = 1200, int height = 800, QObject *parent = nullptr);
+    ~SimWorld();
+
+    // 清空世界并按指定模式和随机种子开始新的一局
+    void reset(GameMode mode, quint32 seed);
+
+    // 推进一帧，input为人类玩家的输入；AI控制的玩家使用AI的决定
+    void step(const TickInput &input = TickInput());
+
+    // 回放模式：不运行AI，所有玩家都使用step()传入的输入
+    void setReplayMode(bool replay) { replayMode = replay; }
+    bool isReplayMode() const { return replayMode; }
+
+    // 上一帧实际执行的输入（包括AI的决定），用于录像
+    const TickInput &getLastInput() const { return lastInput; }
+
+    // 当前状态的校验值，用于确认回放与原对局完全一致
+    quint32 stateChecksum() const;
+
+    // 分阶段计时：开启后每帧累计各阶段耗时（纳秒），默认关闭以免影响正常游戏
+    void setPhaseTiming(bool enabled);
+    void resetPhaseTiming();
+    qint64 getPhaseNanos(int phase) const { return phaseNanos[phase]; }
+    static const char *phaseName(int phase);
+
+    // 是否为实体创建渲染代理（场景项），界面层需要开启，无界面模式保持关闭
+    // 在下一次reset()时生效
+    void setRenderProxies(bool enabled);
+    bool hasRenderProxies() const { return renderProxies; }
+
+    // 逻辑帧率（60的倍数），更高的帧率让快速子弹每帧移动更短的距离
+    void setTickRate(int hz);
+    int getTickRate() const { return tickRate; }
+    qreal getStepScale() const { return stepScale; }
+    qint64 getTickCount() const { return tickCount; }
+
+    // 模拟时间（毫秒），由帧计数换算，用于冷却和状态效果
+    qint64 getTimeMs() const { return tickCount * 1000 / tickRate; }
+    quint32 getSeed() const { return seed; }
+
+    bool isRunning() const { return running; }
+    int getWinnerID() const { return winnerID; }
+    GameMode getGameMode() const { return gameMode; }
+    int getWidth() const { return gameWidth; }
+    int getHeight() const { return gameHeight; }
+
+    Player *getPlayer1() const { return player1; }
+    Player *getPlayer2() const { return player2; }
+    PlayerSprite *getPlayerSprite(const Player *player) const;
+    const EntityRegistry &getRegistry() const { return registry; }
+    const ProjectilePool &getProjectilePool() const { return projectiles; }
+    const StatusEffectSystem &getStatusEffects() const { return effects; }
+
+    // 模拟状态不在场景项里，绘制前调用一次把位置同步到渲染代理
+    void syncRenderProxies();
+
+signals:
+    // 供界面层把新实体的渲染代理加入场景，只在开启渲染代理时发出；实体删除时代理会自动从场景中移除
+    // 复用的投射物也会再次发出projectileSpawned，界面层需判断是否已在场景中
+    void itemSpawned(Item *item);
+    void projectileSpawned(Projectile *projectile);
+    void gameOver(int winnerID);
+
+private:
+    friend class SimWorldBench;     // 微基准测试直接调用下面的各个内核
+
+    void clear();
+    void createPlayers();
+    void createPlatforms();
+    void addPlatform(qreal x, qreal y, qreal width, qreal height, PlatformType type);
+    void spawnItem();
+    void spawnItems();
+    void applyInput(Player *player, quint8 input, quint8 previousInput, qint64 nowMs);
+    void checkCollisions();
+    void finish(Player *winner);
+    void collidePlayerWithPlatforms(Player *player);
+    SweepHit sweepProjectile(int row, Player *player) const;
+    void updateItems();
+    void endPhase(SimPhase phase);
+
+    Player *player1;
+    Player *player2;
+    AI *ai1;                    // 仅在AI互搏模式下控制玩家1
+    AI *ai2;                    // 控制玩家2
+    EntityRegistry registry;        // 所有实体的组件数据
+    PlatformGrid platformGrid;      // 平台的静态网格，创建平台后建立
+    QVector<int> nearbyPlatforms;   // 网格查询得到的平台行号，重复使用避免每次分配
+    ProjectilePool projectiles;     // 投射物系统，回收的渲染代理留在池中复用
+    bool renderProxies;
+    StatusEffectSystem effects;     // 玩家身上的状态效果，按帧计时
+
+    int gameWidth;
+    int gameHeight;
+    int tickRate;
+    qreal stepScale;            // 每帧相当于多少个60Hz帧
+    qint64 tickCount;
+    qint64 nextItemSpawnTime;   // 下一次生成物品的模拟时间
+    quint32 seed;
+    QRandomGenerator rng;       // 本世界独立的随机数流（物品生成等）
+    bool replayMode;
+    bool running;
+    int winnerID;
+    GameMode gameMode;
+
+    TickInput lastInput;        // 上一帧实际执行的输入，用于判断松开按键
+    quint8 aiActions[2] = {0, 0}; // AI最近一次的决定，两次思考之间保持不变
+
+    bool phaseTiming;
+    QElapsedTimer phaseClock;
+    qint64 phaseStart;
+    qint64 phaseNanos[SIM_PHASE_COUNT] = {};
+};
+
+#endif // SIMWORLD_H
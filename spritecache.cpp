@@ -0,0 +1,58 @@
+#include "spritecache.h"
+#include <QCoreApplication>
+#include <QPainter>
+
+SpriteCache &SpriteCache::instance()
+{
+    static SpriteCache cache;
+    return cache;
+}
+
+SpriteCache::SpriteCache()
+{
+    // 与AssetManager相同，QPixmap必须在QApplication销毁前释放
+    if (QCoreApplication *app = QCoreApplication::instance())
+        QObject::connect(app, &QCoreApplication::aboutToQuit, app, [this]() { clear(); });
+}
+
+const Sprite &SpriteCache::get(SpriteKind kind, quint32 key, const QRectF &bounds,
+                               const std::function<void(QPainter *)> &render)
+{
+    QHash<quint32, Sprite> &table = sprites[int(kind)];
+    auto found = table.find(key);
+    if (found != table.end())
+        return *found;
+
+    QRectF area = bounds.toAlignedRect();
+    Sprite sprite;
+    sprite.offset = area.topLeft();
+    sprite.pixmap = QPixmap(area.size().toSize());
+    sprite.pixmap.fill(Qt::transparent);
+
+    QPainter painter(&sprite.pixmap);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.translate(-area.left(), -area.top());
+    render(&painter);
+    painter.end();
+
+    return *table.insert(key, sprite);
+}
+
+void SpriteCache::clear(SpriteKind kind)
+{
+    sprites[int(kind)].clear();
+}
+
+void SpriteCache::clear()
+{
+    for (QHash<quint32, Sprite> &table : sprites)
+        table.clear();
+}
+
+int SpriteCache::size() const
+{
+    int total = 0;
+    for (const QHash<quint32, Sprite> &table : sprites)
+        total += table.size();
+    return total;
+}
@@ -0,0 +1,54 @@
+#ifndef SPRITECACHE_H
+#define SPRITECACHE_H
+
+#include <QHash>
+#include <QPixmap>
+#include <QPointF>
+#include <QRectF>
+#include <functional>
+
+class QPainter;
+
+// 精灵的种类，每种单独一张表，可以只清除其中一种
+enum class SpriteKind {
+    PLAYER,
+    ITEM,
+    PROJECTILE
+};
+
+const int SPRITE_KIND_COUNT = 3;
+
+// 预先画好的一种外观：图片和它的左上角相对于渲染代理原点的偏移
+struct Sprite
+{
+    QPixmap pixmap;
+    QPointF offset;
+};
+
+// 精灵缓存：渲染代理的每种外观只用QPainter画一次，之后每帧只需一次drawPixmap
+// 外观由代理自己编码成key（例如玩家×朝向×下蹲×武器×护甲），第一次用到时才画，
+// 因此不管屏幕上有多少实体，绘制开销都只和实体数量成正比，与外观的复杂程度无关
+// 只能在界面线程使用
+class SpriteCache
+{
+public:
+    static SpriteCache &instance();
+
+    // 取key对应的外观，没有时在bounds大小的透明图上调用render绘制并缓存
+    // bounds是代理坐标系中的绘制范围，可以超出代理的矩形（例如玩家手中的武器）
+    const Sprite &get(SpriteKind kind, quint32 key, const QRectF &bounds,
+                      const std::function<void(QPainter *)> &render);
+
+    // 外观的绘制代码或素材变化时清除对应种类的缓存
+    void clear(SpriteKind kind);
+    void clear();
+
+    int size() const;
+
+private:
+    SpriteCache();
+
+    QHash<quint32, Sprite> sprites[SPRITE_KIND_COUNT];
+};
+
+#endif // SPRITECACHE_H
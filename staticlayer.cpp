@@ -0,0 +1,84 @@
+#include "staticlayer.h"
+#include <QPainter>
+
+StaticLayer::StaticLayer(const QSize &size)
+    : size(size), backgroundOpacity(1.0), baseColor(30, 30, 30), dirty(true)
+{
+}
+
+void StaticLayer::setBackground(const QPixmap &image, qreal opacity, const QColor &color)
+{
+    background = image;
+    backgroundOpacity = opacity;
+    baseColor = color;
+    dirty = true;
+}
+
+bool StaticLayer::rebuild(const EntityTable &platforms)
+{
+    if (!dirty && platformBounds.size() == platforms.size())
+    {
+        bool changed = false;
+        for (int i = 0; i < platforms.size() && !changed; i++)
+        {
+            changed = platformBounds[i] != platforms.bounds(i) || platformTypes[i] != platforms.subtype[i];
+        }
+        if (!changed)
+            return false;
+    }
+
+    compose(platforms);
+    return true;
+}
+
+void StaticLayer::compose(const EntityTable &platforms)
+{
+    layer = QPixmap(size);
+    layer.fill(baseColor);
+
+    QPainter painter(&layer);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform);
+
+    if (!background.isNull())
+    {
+        painter.setOpacity(backgroundOpacity);
+        painter.drawPixmap(0, 0, background);
+        painter.setOpacity(1.0);
+    }
+
+    // 用平台渲染代理自己的绘制代码画到合成图上
+    platformBounds.resize(platforms.size());
+    platformTypes.resize(platforms.size());
+    for (int i = 0; i < platforms.size(); i++)
+    {
+        platformBounds[i] = platforms.bounds(i);
+        platformTypes[i] = platforms.subtype[i];
+
+        QGraphicsItem *proxy = platforms.proxy[i];
+        if (!proxy)
+            continue;
+        painter.save();
+        painter.translate(platforms.x[i], platforms.y[i]);
+        proxy->paint(&painter, nullptr, nullptr);
+        painter.restore();
+    }
+    painter.end();
+
+    dirty = false;
+    update();
+}
+
+QRectF StaticLayer::boundingRect() const
+{
+    return QRectF(0, 0, size.width(), size.height());
+}
+
+void StaticLayer::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+{
+    Q_UNUSED(option);
+    Q_UNUSED(widget);
+
+    // 整层只有一次贴图
+    painter->drawPixmap(0, 0, layer);
+}
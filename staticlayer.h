@@ -0,0 +1,46 @@
+#ifndef STATICLAYER_H
+#define STATICLAYER_H
+
+#include <QGraphicsItem>
+#include <QPixmap>
+#include <QColor>
+#include <QVector>
+#include "entityregistry.h"
+
+// 静态层：背景图和所有平台都不会移动，合成为一张不透明的图，每帧只需绘制一次
+// 背景的透明度在合成时就混合到底色上，平台的渲染代理也只在合成时绘制，不加入场景
+// 只有背景或平台的位置、尺寸、类型变化（换关卡）时才重新合成
+class StaticLayer : public QGraphicsItem
+{
+public:
+    explicit StaticLayer(const QSize &size);
+
+    // 背景图按opacity混合到baseColor上，图片为空时只用底色
+    void setBackground(const QPixmap &image, qreal opacity, const QColor &baseColor);
+
+    // 平台与上次合成时不同才重新合成，返回是否重新合成
+    bool rebuild(const EntityTable &platforms);
+
+    // 合成好的整层，批量渲染器直接绘制它
+    const QPixmap &pixmap() const { return layer; }
+
+    QRectF boundingRect() const override;
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
+
+private:
+    void compose(const EntityTable &platforms);
+
+    QSize size;
+    QPixmap background;
+    qreal backgroundOpacity;
+    QColor baseColor;
+    bool dirty;
+
+    QPixmap layer;
+
+    // 上次合成时的平台，用于判断关卡是否变化
+    QVector<QRectF> platformBounds;
+    QVector<int> platformTypes;
+};
+
+#endif // STATICLAYER_H
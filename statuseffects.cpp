@@ -0,0 +1,173 @@
+#include "statuseffects.h"
+
+StatusEffectSystem::StatusEffectSystem()
+    : tickRate(60)
+{
+    wheel.resize(WHEEL_SIZE);
+}
+
+int StatusEffectSystem::msToTicks(int ms) const
+{
+    // 向上取整，效果不会比设定的时间短
+    return int((qint64(ms) * tickRate + 999) / 1000);
+}
+
+int StatusEffectSystem::findRow(EntityId targetId, StatusEffectType effectType) const
+{
+    for (int i = 0; i < target.size(); i++)
+    {
+        if (target[i] == targetId && type[i] == effectType)
+            return i;
+    }
+    return -1;
+}
+
+void StatusEffectSystem::apply(EntityId targetId, StatusEffectType effectType, qint64 nowTick)
+{
+    if (effectType == StatusEffectType::NONE)
+        return;
+
+    const StatusEffectStats &stats = statusEffectStats(effectType);
+    int row = findRow(targetId, effectType);
+    if (row < 0)
+    {
+        int slot;
+        if (!freeSlots.isEmpty())
+        {
+            slot = freeSlots.takeLast();
+        }
+        else
+        {
+            slot = slotRow.size();
+            slotRow.append(-1);
+            slotGeneration.append(0);
+        }
+
+        row = target.size();
+        target.append(targetId);
+        type.append(effectType);
+        endTick.append(0);
+        nextPeriodTick.append(-1);
+        periodTicks.append(0);
+        rowSlot.append(slot);
+        slotRow[slot] = row;
+    }
+    else
+    {
+        // 重新计时：时间轮中按旧结束帧挂上的项作废
+        slotGeneration[rowSlot[row]]++;
+    }
+
+    endTick[row] = nowTick + msToTicks(stats.durationMs);
+    periodTicks[row] = stats.periodMs > 0 ? msToTicks(stats.periodMs) : 0;
+    nextPeriodTick[row] = stats.periodMs > 0 ? nowTick + periodTicks[row] : -1;
+    schedule(row);
+}
+
+void StatusEffectSystem::schedule(int row)
+{
+    int slot = rowSlot[row];
+    WheelEntry entry;
+    entry.slot = slot;
+    entry.generation = slotGeneration[slot];
+    wheel[int(endTick[row] % WHEEL_SIZE)].append(entry);
+}
+
+void StatusEffectSystem::removeRow(int row)
+{
+    int slot = rowSlot[row];
+    slotGeneration[slot]++;
+    slotRow[slot] = -1;
+    freeSlots.append(slot);
+
+    // 交换后弹出
+    int last = target.size() - 1;
+    if (row != last)
+    {
+        target[row] = target[last];
+        type[row] = type[last];
+        endTick[row] = endTick[last];
+        nextPeriodTick[row] = nextPeriodTick[last];
+        periodTicks[row] = periodTicks[last];
+        rowSlot[row] = rowSlot[last];
+        slotRow[rowSlot[row]] = row;
+    }
+    target.removeLast();
+    type.removeLast();
+    endTick.removeLast();
+    nextPeriodTick.removeLast();
+    periodTicks.removeLast();
+    rowSlot.removeLast();
+}
+
+void StatusEffectSystem::update(qint64 nowTick, EntityRegistry &registry)
+{
+    // 周期效果：结束帧当帧的周期仍然生效
+    EntityTable &players = registry.table(EntityKind::PLAYER);
+    for (int i = 0; i < target.size(); i++)
+    {
+        if (nextPeriodTick[i] < 0)
+            continue;
+
+        int heal = statusEffectStats(type[i]).healPerPeriod;
+        while (nextPeriodTick[i] <= nowTick && nextPeriodTick[i] <= endTick[i])
+        {
+            int row = registry.rowOf(target[i]);
+            if (row >= 0)
+                players.health[row] = qMin(players.health[row] + heal, 100);
+            nextPeriodTick[i] += periodTicks[i];
+        }
+    }
+
+    // 到期：只看时间轮当前的格子，还没到结束帧的（下一圈的）留在格子里
+    QVector<WheelEntry> &bucket = wheel[int(nowTick % WHEEL_SIZE)];
+    int kept = 0;
+    for (int i = 0; i < bucket.size(); i++)
+    {
+        WheelEntry entry = bucket[i];
+        if (slotGeneration[entry.slot] != entry.generation)
+            continue;
+
+        int row = slotRow[entry.slot];
+        if (endTick[row] > nowTick)
+        {
+            bucket[kept++] = entry;
+            continue;
+        }
+        removeRow(row);
+    }
+    bucket.resize(kept);
+}
+
+void StatusEffectSystem::clear()
+{
+    target.clear();
+    type.clear();
+    endTick.clear();
+    nextPeriodTick.clear();
+    periodTicks.clear();
+    rowSlot.clear();
+    slotRow.clear();
+    slotGeneration.clear();
+    freeSlots.clear();
+    for (QVector<WheelEntry> &bucket : wheel)
+    {
+        bucket.clear();
+    }
+}
+
+qreal StatusEffectSystem::speedMultiplier(EntityId targetId) const
+{
+    qreal multiplier = 1.0;
+    for (int i = 0; i < target.size(); i++)
+    {
+        if (target[i] == targetId)
+            multiplier *= statusEffectStats(type[i]).speedMultiplier;
+    }
+    return multiplier;
+}
+
+bool StatusEffectSystem::hasEffect(EntityId targetId, StatusEffectType effectType) const
+{
+    return findRow(targetId, effectType) >= 0;
+}
@@ -0,0 +1,69 @@
+#ifndef STATUSEFFECTS_H
+#define STATUSEFFECTS_H
+
+#include <QVector>
+#include "gamedata.h"
+#include "entityregistry.h"
+
+// 状态效果系统：所有玩家身上的所有效果存放在几组连续数组中，第row行是一个效果，
+// 由游戏世界每帧调用一次update()，完全按帧计数计时，可以暂停、快进，也能在无界面模式下不限速运行
+// 周期效果（如每秒回血）每帧线性扫描一遍；到期由时间轮处理：
+// 效果按结束帧挂在轮上对应的格子里，每帧只检查当前格子，不需要比较所有效果的结束时间
+// 新增一种效果只需要在STATUS_EFFECT_STATS中加一行
+class StatusEffectSystem
+{
+public:
+    StatusEffectSystem();
+
+    // 帧率决定毫秒到帧数的换算，需在apply()之前设置
+    void setTickRate(int hz) { tickRate = hz; }
+
+    // 给target施加效果，nowTick为当前帧；已有同种效果时重新计时
+    void apply(EntityId target, StatusEffectType type, qint64 nowTick);
+
+    // 推进到nowTick：执行到期的周期效果，移除结束的效果
+    void update(qint64 nowTick, EntityRegistry &registry);
+
+    // 删除所有效果（新的一局开始时调用）
+    void clear();
+
+    // target身上所有效果的移动速度倍率之积，没有效果时为1
+    qreal speedMultiplier(EntityId target) const;
+    bool hasEffect(EntityId target, StatusEffectType type) const;
+    int size() const { return target.size(); }
+
+private:
+    // 时间轮的格数，超过一圈的效果在转到时检查结束帧，没到就留到下一圈
+    static const int WHEEL_SIZE = 256;
+
+    // 时间轮中的一项：效果的槽位和世代，效果删除或重新计时后旧的项自动失效
+    struct WheelEntry
+    {
+        int slot;
+        quint32 generation;
+    };
+
+    int findRow(EntityId target, StatusEffectType type) const;
+    int msToTicks(int ms) const;
+    void schedule(int row);
+    void removeRow(int row);
+
+    int tickRate;
+
+    // 每个效果一行
+    QVector<EntityId> target;
+    QVector<StatusEffectType> type;
+    QVector<qint64> endTick;
+    QVector<qint64> nextPeriodTick;     // 没有周期效果时为-1
+    QVector<int> periodTicks;
+    QVector<int> rowSlot;
+
+    // 槽位到行的映射，删除时行会交换，时间轮通过槽位找到效果
+    QVector<int> slotRow;
+    QVector<quint32> slotGeneration;
+    QVector<int> freeSlots;
+
+    QVector<QVector<WheelEntry>> wheel;
+};
+
+#endif // STATUSEFFECTS_H
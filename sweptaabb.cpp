@@ -0,0 +1,67 @@
+#include "sweptaabb.h"
+#include <QtGlobal>
+
+bool aabbOverlap(const QRectF &a, const QRectF &b)
+{
+    return a.left() <= b.right() && b.left() <= a.right() &&
+           a.top() <= b.bottom() && b.top() <= a.bottom();
+}
+
+// 在一个轴上求进入和离开目标的时刻，更新[enter, exit]区间
+// 返回false表示这个轴上永远不会重叠
+static bool sweepAxis(qreal boxMin, qreal boxMax, qreal targetMin, qreal targetMax,
+                      qreal delta, qreal &enter, qreal &exit, bool &enterOnThisAxis)
+{
+    enterOnThisAxis = false;
+    if (qFuzzyIsNull(delta))
+    {
+        // 这个轴上不移动，只能一直重叠或一直分离
+        return boxMax >= targetMin && boxMin <= targetMax;
+    }
+
+    qreal t1 = (targetMin - boxMax) / delta;
+    qreal t2 = (targetMax - boxMin) / delta;
+    if (t1 > t2)
+        qSwap(t1, t2);
+
+    if (t1 > enter)
+    {
+        enter = t1;
+        enterOnThisAxis = true;
+    }
+    exit = qMin(exit, t2);
+    return enter <= exit;
+}
+
+SweepHit sweepAABB(const QRectF &box, const QPointF &displacement, const QRectF &target)
+{
+    SweepHit result;
+
+    // 起点已经重叠
+    if (aabbOverlap(box, target))
+    {
+        result.hit = true;
+        result.time = 0.0;
+        return result;
+    }
+
+    qreal enter = 0.0;
+    qreal exit = 1.0;
+    bool enterX = false;
+    bool enterY = false;
+
+    if (!sweepAxis(box.left(), box.right(), target.left(), target.right(),
+                   displacement.x(), enter, exit, enterX))
+        return result;
+    if (!sweepAxis(box.top(), box.bottom(), target.top(), target.bottom(),
+                   displacement.y(), enter, exit, enterY))
+        return result;
+
+    result.hit = true;
+    result.time = enter;
+    if (enterY)
+        result.normal = QPointF(0, displacement.y() > 0 ? -1 : 1);
+    else if (enterX)
+        result.normal = QPointF(displacement.x() > 0 ? -1 : 1, 0);
+    return result;
+}
@@ -0,0 +1,23 @@
+#ifndef SWEPTAABB_H
+#define SWEPTAABB_H
+
+#include <QRectF>
+#include <QPointF>
+
+// 扫掠AABB检测的结果
+struct SweepHit
+{
+    bool hit = false;
+    qreal time = 1.0;       // 最早接触的时刻，0为起点，1为终点
+    QPointF normal;         // 接触面的法线（指向移动的盒子），起点已重叠时为0
+};
+
+// 两个矩形是否重叠（边缘接触也算）
+bool aabbOverlap(const QRectF &a, const QRectF &b);
+
+// 盒子box沿displacement移动一帧，求与静止的target最早接触的时刻
+// 目标也在移动时，传入两者位移之差即可
+// 只检查终点会让快速物体穿过薄平台，这里检查的是整条移动路径
+SweepHit sweepAABB(const QRectF &box, const QPointF &displacement, const QRectF &target);
+
+#endif // SWEPTAABB_H
@@ -0,0 +1,18 @@
+#ifndef TICKRATE_H
+#define TICKRATE_H
+
+#include <QtGlobal>
+
+// 基准帧率：所有速度、重力和寿命都以60Hz的一帧为单位
+const int SIM_BASE_TICK_RATE = 60;
+
+// 逻辑帧率只能是基准帧率的倍数（60/120/240...），保证AI按60Hz思考
+// 游戏世界和固定步长循环都用它取整，两边的帧率总是一致
+inline int roundTickRate(int hz)
+{
+    // 取最接近的60的倍数
+    int multiple = qMax(1, (hz + SIM_BASE_TICK_RATE / 2) / SIM_BASE_TICK_RATE);
+    return multiple * SIM_BASE_TICK_RATE;
+}
+
+#endif // TICKRATE_H
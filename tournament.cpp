@@ -0,0 +1,204 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <QThread>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QAtomicInt>
+#include <QVector>
+#include "simworld.h"
+
+// 一场对战的结果
+struct MatchResult
+{
+    quint32 seed = 0;
+    int winnerID = 0;
+    qint64 ticks = 0;
+};
+
+// 多个工作线程共享的对战队列和结果
+struct Tournament
+{
+    quint32 firstSeed = 1;
+    int tickRate = SIM_BASE_TICK_RATE;
+    qint64 maxTicks = 0;
+    QAtomicInt nextMatch;
+    QVector<MatchResult> results;   // 预先分配好，每个线程只写自己领到的下标
+};
+
+// 工作线程：拥有一个独立的游戏世界，不断领取下一场对战直到全部完成
+// 每个线程的世界互不共享，因此不需要加锁；阶段耗时各自累计，最后再汇总
+class MatchWorker : public QRunnable
+{
+public:
+    explicit MatchWorker(Tournament *tournament)
+        : tournament(tournament)
+    {
+        setAutoDelete(false);
+    }
+
+    void run() override
+    {
+        SimWorld world;
+        world.setTickRate(tournament->tickRate);
+        world.setPhaseTiming(true);
+
+        int matchCount = tournament->results.size();
+        int match;
+        while ((match = tournament->nextMatch.fetchAndAddRelaxed(1)) < matchCount)
+        {
+            MatchResult &result = tournament->results[match];
+            result.seed = tournament->firstSeed + match;
+            world.reset(GameMode::AI_VS_AI, result.seed);
+
+            while (world.isRunning() && result.ticks < tournament->maxTicks)
+            {
+                world.step();
+                result.ticks++;
+            }
+            result.winnerID = world.getWinnerID();
+        }
+
+        for (int i = 0; i < SIM_PHASE_COUNT; i++)
+        {
+            phaseNanos[i] = world.getPhaseNanos(i);
+        }
+
+        const ProjectilePool &pool = world.getProjectilePool();
+        poolHighWaterMark = pool.getHighWaterMark();
+        poolGrownRows = pool.getGrownRowCount();
+        poolAcquires = pool.getAcquireCount();
+    }
+
+    qint64 phaseNanos[SIM_PHASE_COUNT] = {};
+    int poolHighWaterMark = 0;
+    qint64 poolGrownRows = 0;
+    qint64 poolAcquires = 0;
+
+private:
+    Tournament *tournament;
+};
+
+// 离线锦标赛：在线程池上不限速地跑大量AI互搏，用于快速评估AI的改动
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+    QCoreApplication::setApplicationName("HW1_1_tournament");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("多线程AI对战锦标赛");
+    parser.addHelpOption();
+    QCommandLineOption matchesOption("matches", "对战总场数", "n", "100");
+    QCommandLineOption threadsOption("threads", "工作线程数（默认等于CPU核心数）", "n",
+                                     QString::number(QThread::idealThreadCount()));
+    QCommandLineOption seedOption("seed", "第一场的随机种子，第n场使用seed+n", "seed", "1");
+    QCommandLineOption maxSecondsOption("max-seconds", "单场最长游戏时间（秒），超过判为平局", "seconds", "600");
+    QCommandLineOption tickRateOption("tick-rate", "逻辑帧率（60/120/240）", "hz", "60");
+    QCommandLineOption verboseOption("verbose", "输出每一场的结果");
+    parser.addOption(matchesOption);
+    parser.addOption(threadsOption);
+    parser.addOption(seedOption);
+    parser.addOption(maxSecondsOption);
+    parser.addOption(tickRateOption);
+    parser.addOption(verboseOption);
+    parser.process(a);
+
+    int matches = qMax(1, parser.value(matchesOption).toInt());
+    int threads = qBound(1, parser.value(threadsOption).toInt(), matches);
+
+    // 帧率按世界的规则取整，保证与GUI和录像一致
+    SimWorld probe;
+    probe.setTickRate(parser.value(tickRateOption).toInt());
+
+    Tournament tournament;
+    tournament.firstSeed = parser.value(seedOption).toUInt();
+    tournament.tickRate = probe.getTickRate();
+    tournament.maxTicks = qint64(qMax(1, parser.value(maxSecondsOption).toInt())) * tournament.tickRate;
+    tournament.nextMatch.storeRelaxed(0);
+    tournament.results.resize(matches);
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(threads);
+
+    QVector<MatchWorker *> workers;
+    for (int i = 0; i < threads; i++)
+    {
+        workers.append(new MatchWorker(&tournament));
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    for (MatchWorker *worker : workers)
+    {
+        pool.start(worker);
+    }
+    pool.waitForDone();
+    qint64 elapsedNs = qMax<qint64>(1, timer.nsecsElapsed());
+
+    // 汇总结果
+    QTextStream out(stdout);
+    int wins[3] = {0, 0, 0}; // 平局、玩家1、玩家2
+    qint64 totalTicks = 0;
+    for (const MatchResult &result : tournament.results)
+    {
+        wins[result.winnerID]++;
+        totalTicks += result.ticks;
+        if (parser.isSet(verboseOption))
+        {
+            out << QString("种子=%1 胜者=%2 帧数=%3\n")
+                       .arg(result.seed).arg(result.winnerID).arg(result.ticks);
+        }
+    }
+
+    qint64 phaseNanos[SIM_PHASE_COUNT] = {};
+    qint64 totalPhaseNanos = 0;
+    int poolHighWaterMark = 0;
+    qint64 poolGrownRows = 0;
+    qint64 poolAcquires = 0;
+    for (MatchWorker *worker : workers)
+    {
+        poolHighWaterMark = qMax(poolHighWaterMark, worker->poolHighWaterMark);
+        poolGrownRows += worker->poolGrownRows;
+        poolAcquires += worker->poolAcquires;
+        for (int i = 0; i < SIM_PHASE_COUNT; i++)
+        {
+            phaseNanos[i] += worker->phaseNanos[i];
+            totalPhaseNanos += worker->phaseNanos[i];
+        }
+    }
+    qDeleteAll(workers);
+
+    double seconds = elapsedNs / 1e9;
+    double avgTicks = double(totalTicks) / matches;
+    out << QString("共%1场，%2个线程，用时%3秒\n").arg(matches).arg(threads).arg(seconds, 0, 'f', 3);
+    out << QString("每秒%1场，每秒%2帧\n")
+               .arg(matches / seconds, 0, 'f', 1).arg(totalTicks / seconds, 0, 'f', 0);
+    out << QString("玩家1胜率%1%，玩家2胜率%2%，平局%3%\n")
+               .arg(100.0 * wins[1] / matches, 0, 'f', 1)
+               .arg(100.0 * wins[2] / matches, 0, 'f', 1)
+               .arg(100.0 * wins[0] / matches, 0, 'f', 1);
+    out << QString("平均每场%1帧（%2秒游戏时间）\n")
+               .arg(avgTicks, 0, 'f', 0).arg(avgTicks / tournament.tickRate, 0, 'f', 1);
+
+    // 各阶段每帧平均耗时（所有线程合计的CPU时间除以总帧数）
+    out << "每帧各阶段平均耗时:\n";
+    for (int i = 0; i < SIM_PHASE_COUNT; i++)
+    {
+        double perTick = totalTicks > 0 ? double(phaseNanos[i]) / totalTicks : 0.0;
+        double share = totalPhaseNanos > 0 ? 100.0 * phaseNanos[i] / totalPhaseNanos : 0.0;
+        out << QString("  %1 %2 ns (%3%)\n")
+                   .arg(QString(SimWorld::phaseName(i)), -12)
+                   .arg(perTick, 8, 'f', 1)
+                   .arg(share, 0, 'f', 1);
+    }
+
+    // 投射物对象池：同时活动的最大数量和投射物表中行的复用比例
+    // 无界面模式不创建渲染代理，这里统计的是不需要扩充投射物表的发射所占的比例
+    double reuseRate = poolAcquires > 0 ? 100.0 * (poolAcquires - poolGrownRows) / poolAcquires : 0.0;
+    out << QString("投射物池: 最多同时%1个，发射%2次，扩充投射物表%3次，行复用率%4%\n")
+               .arg(poolHighWaterMark).arg(poolAcquires).arg(poolGrownRows).arg(reuseRate, 0, 'f', 1);
+    out.flush();
+
+    return 0;
+}
@@ -1,35 +1,32 @@
 #ifndef WEAPON_H
 #define WEAPON_H
 
-#include <QObject>
-#include "projectile.h"
+#include <QtGlobal>
+#include "gamedata.h"
 
-enum class WeaponType {
-    FIST,
-    KNIFE,
-    BALL,
-    RIFLE,
-    SNIPER
-};
+class ProjectilePool;
 
-class Weapon : public QObject
+// 武器是普通的值类型，直接存放在玩家表的武器列中
+// 换武器、弹药用光时原地赋值，不分配内存
+class Weapon
 {
-    Q_OBJECT
-
 public:
-    Weapon(WeaponType type);
+    explicit Weapon(WeaponType type = WeaponType::FIST);
     bool isAmmoEmpty() const { return ammo == 0; }
 
-    Projectile* fire(qreal x, qreal y, bool facingRight, int ownerID, bool* ammoEmpty = nullptr);
+    // nowMs为模拟时间（毫秒），冷却时间按它计算，与系统时钟无关
+    // 投射物加入对象池的投射物表，返回false表示没有开火
+    bool fire(ProjectilePool &pool, qreal x, qreal y, bool facingRight, int ownerID, qint64 nowMs, bool* ammoEmpty = nullptr);
     WeaponType getType() const { return type; }
     int getAmmo() const { return ammo; }
 
+    // 伤害、冷却时间等固定数值来自WEAPON_STATS
+    const WeaponStats &getStats() const { return weaponStats(type); }
+
 private:
     WeaponType type;
     int ammo;
-    int damage;
-    int cooldown;
-    int lastFireTime;
+    qint64 lastFireTime;
 };
 
 #endif // WEAPON_H
@@ -0,0 +1,83 @@
+#include "worldrenderer.h"
+#include <QPainter>
+#include <QPaintEvent>
+#include "item.h"
+#include "playersprite.h"
+#include "projectile.h"
+
+WorldRenderer::WorldRenderer(const SimWorld *world, const StaticLayer *staticLayer, const Hud *hud,
+                             FrameProfiler *profiler, QWidget *parent)
+    : QWidget(parent), world(world), staticLayer(staticLayer), hud(hud), profiler(profiler), alpha(1.0)
+{
+    // 静态层是不透明的，每帧都会覆盖整个控件
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    setAttribute(Qt::WA_NoSystemBackground);
+    setFocusPolicy(Qt::StrongFocus);
+}
+
+void WorldRenderer::setAlpha(qreal value)
+{
+    alpha = value;
+    update();
+}
+
+void WorldRenderer::paintEvent(QPaintEvent *event)
+{
+    ProfileScope scope(*profiler, PROFILE_PAINT);
+    QPainter painter(this);
+    QRectF visible = event->rect();
+
+    // 按层绘制，同一层的实体外观相同的居多，连续绘制同一张图
+    painter.drawPixmap(0, 0, staticLayer->pixmap());
+    drawTable(painter, EntityKind::ITEM, visible);
+    drawTable(painter, EntityKind::PLAYER, visible);
+    drawTable(painter, EntityKind::PROJECTILE, visible);
+
+    if (hud->isVisible())
+        hud->draw(&painter);
+
+    if (profiler->isOverlayVisible())
+        profiler->drawOverlay(&painter, FrameProfiler::overlayRect(width()));
+}
+
+void WorldRenderer::drawTable(QPainter &painter, EntityKind kind, const QRectF &visible)
+{
+    const EntityTable &table = world->getRegistry().table(kind);
+    for (int i = 0; i < table.size(); i++)
+    {
+        QGraphicsItem *proxy = table.proxy[i];
+        if (!proxy)
+            continue;
+
+        const Sprite *sprite = nullptr;
+        qreal opacity = 1.0;
+        switch (kind)
+        {
+        case EntityKind::ITEM:
+            sprite = &static_cast<Item *>(proxy)->sprite();
+            break;
+        case EntityKind::PLAYER:
+            sprite = &static_cast<PlayerSprite *>(proxy)->sprite();
+            opacity = table.hasFlag(i, ENTITY_HIDDEN) ? 0.3 : 1.0;
+            break;
+        case EntityKind::PROJECTILE:
+            sprite = &static_cast<Projectile *>(proxy)->sprite();
+            break;
+        case EntityKind::PLATFORM:
+            break;
+        }
+        if (!sprite)
+            continue;
+
+        // 在最近两帧之间插值显示
+        QPointF previous = table.previousPosition(i);
+        QPointF position = previous + (table.position(i) - previous) * alpha + sprite->offset;
+        QRectF target(position, sprite->pixmap.size());
+        if (!visible.intersects(target))
+            continue;
+
+        painter.setOpacity(opacity);
+        painter.drawPixmap(position, sprite->pixmap);
+    }
+    painter.setOpacity(1.0);
+}
@@ -0,0 +1,42 @@
+#ifndef WORLDRENDERER_H
+#define WORLDRENDERER_H
+
+#include <QWidget>
+#include "simworld.h"
+#include "staticlayer.h"
+#include "hud.h"
+#include "frameprofiler.h"
+
+// 界面的两种渲染方式
+enum class RenderBackend {
+    SCENE,      // QGraphicsView：每个实体是一个场景项，各自建索引、各自绘制
+    BATCHED     // WorldRenderer：一个控件每帧直接从实体注册表画出整个世界
+};
+
+// 批量渲染器：不经过QGraphicsScene，在paintEvent中按层依次绘制
+// 静态层、物品、玩家、投射物和信息栏，每层线性遍历注册表中对应的表，
+// 用渲染代理在精灵缓存中的外观一次drawPixmap画出，不在重绘区域内的实体直接跳过
+// 实体位置在上一帧和当前帧之间按alpha插值，不修改渲染代理
+class WorldRenderer : public QWidget
+{
+public:
+    WorldRenderer(const SimWorld *world, const StaticLayer *staticLayer, const Hud *hud,
+                  FrameProfiler *profiler, QWidget *parent = nullptr);
+
+    // 设置插值系数并请求重绘
+    void setAlpha(qreal alpha);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    void drawTable(QPainter &painter, EntityKind kind, const QRectF &visible);
+
+    const SimWorld *world;
+    const StaticLayer *staticLayer;
+    const Hud *hud;
+    FrameProfiler *profiler;
+    qreal alpha;
+};
+
+#endif // WORLDRENDERER_H